@@ -2,47 +2,15 @@
 
 #include "Vector2D.hpp"
 #include "Game.hpp"
+#include "BitBoard.hpp"
+#include "Frontier.hpp"
+#include "Elimination.hpp"
+#include "Random.hpp"
 
-#include <unordered_set>
-
-namespace std
-{
-    template <>
-    struct hash<def::Vector2i>
-    {
-        size_t operator()(const def::Vector2i& v) const
-        {
-            size_t h1 = std::hash<int>{}(v.x);
-            size_t h2 = std::hash<int>{}(v.y);
-
-            std::size_t mult = 0x345678UL;
-
-            std::size_t combined = 0x345678UL;
-            combined = (combined ^ h1) * mult;
-            combined = (combined ^ h2) * mult;
-
-            return combined + 97531;
-        }
-    };
-}
-
-template <class T>
-bool Vector_Contains(const std::vector<T>& vector, const T& value)
-{
-    return std::ranges::find(vector, value) != vector.end();
-}
-
-template <class T>
-bool UnorderedSet_IsSubset(const std::unordered_set<T>& set, const std::unordered_set<T>& subset)
-{
-    for (const auto& v : subset)
-    {
-        if (!set.contains(v))
-            return false;
-    }
-
-    return true;
-}
+#include <deque>
+#include <optional>
+#include <span>
+#include <unordered_map>
 
 /*
 Logical statement about a Minesweeper game
@@ -51,24 +19,103 @@ and a count of the number of those cells which are mines.
 */
 struct Sentence
 {
-    Sentence(const std::unordered_set<def::Vector2i> cells, int minesCount);
+    Sentence(const CellSet& cells, int minesCount);
 
     bool operator==(const Sentence& other) const;
 
-    std::unordered_set<def::Vector2i> GetKnownMines() const;
-    std::unordered_set<def::Vector2i> GetKnownSafes() const;
+    CellSet GetKnownMines() const;
+    CellSet GetKnownSafes() const;
 
-    void MarkMine(const def::Vector2i& cell);
-    void MarkSafe(const def::Vector2i& cell);
+    // Cells are passed as indices on the board (y * width + x),
+    // returns true if the sentence contained the cell
+    bool MarkMine(int cell);
+    bool MarkSafe(int cell);
 
-    std::unordered_set<def::Vector2i> cells;
+    CellSet cells;
     int minesCount;
+
+    // Hash of the cells and the count, updated whenever a cell is marked
+    size_t hash;
+
+private:
+    void UpdateHash();
+};
+
+// Amount of work that was done to reach a fixpoint of the inference
+struct InferenceStats
+{
+    int rounds = 0;
+    int sentencesTouched = 0;
+    int eliminations = 0;
+};
+
+enum class DeductionEngine
+{
+    // Subtracts sentences that are subsets of other sentences
+    Subset,
+
+    // Runs the subset rule and then solves the whole frontier as a system
+    // of linear equations, so it also finds the deductions that need
+    // three or more sentences
+    Elimination
+};
+
+// The way the AI chooses a cell when it knows no safe cells
+enum class GuessStrategy
+{
+    // Any cell that is not known to be a mine
+    Random,
+
+    // The cell with the lowest probability of a mine
+    LowestProbability,
+
+    // Among the cells with the lowest probability the one with the fewest
+    // neighbours, corners and then edges are more likely to open a region
+    Corners,
+
+    // Among the cells that are almost as safe as the best one the cell
+    // whose number is the hardest to predict, so it tells the most
+    InformationGain
+};
+
+// How far MinesweeperAI::BestMove got before it chose the move
+enum class AnswerCompleteness
+{
+    // No time was left for the probabilities, the move is a random guess
+    Fallback,
+
+    // The Random strategy chose the move, it doesn't need the probabilities
+    Random,
+
+    // The deadline cut off the enumeration or the sampling,
+    // the probabilities are rough
+    Partial,
+
+    // Some probabilities were estimated by sampling
+    Sampled,
+
+    // All probabilities are exact
+    Exact,
+
+    // The move is known to be safe
+    Deduced
+};
+
+struct BestMoveResult
+{
+    // Empty if there are no cells left to open
+    std::optional<def::Vector2i> move;
+
+    // Probability of a mine in the cell of the move
+    double mineProbability = 0.0;
+
+    AnswerCompleteness completeness = AnswerCompleteness::Deduced;
 };
 
 class MinesweeperAI
 {
 public:
-    MinesweeperAI(const def::Vector2i& boardSize);
+    MinesweeperAI(const def::Vector2i& boardSize, int minesCount, Random random = Random());
 
     /*
     Marks a cell as a mine, and updates all knowledge
@@ -87,14 +134,22 @@ public:
     safe cell, how many neighboring cells have mines in them.
     */
     void AddKnowledge(const def::Vector2i& cell, int minesCount);
+
+    /*
+    Adds the knowledge of many opened cells, such as the ones
+    that Minesweeper::Reveal returns. All cells are added first
+    and then the inference runs only once for the whole batch.
+    */
+    void AddKnowledgeBatch(std::span<const std::pair<def::Vector2i, int>> cells);
     
     /*
     Returns a safe cell to choose on the Minesweeper board.
     The move must be known to be safe, and not already a move
     that has been made.
 
-    This function may use the knowledge in self.mines, self.safes
-    and self.moves_made, but should not modify any of those values.
+    Safe cells are taken from a queue in the order they were found.
+    Cells at the front of the queue that were opened since are dropped
+    from it, the knowledge of mines, safes and moves is not modified.
     */
     std::optional<def::Vector2i> MakeSafeMove();
 
@@ -103,25 +158,197 @@ public:
     Should choose randomly among cells that:
         1) have not already been chosen, and
         2) are not known to be mines
+    Every such cell is equally likely and the call takes constant time.
     */
     std::optional<def::Vector2i> MakeRandomMove();
 
+    /*
+    Returns a move to make on the Minesweeper board when
+    there are no known safe moves. Chooses the cell with
+    the lowest probability of being a mine, the probabilities
+    are computed by enumerating all mine layouts that agree
+    with the knowledge base and the total number of mines.
+    */
+    std::optional<def::Vector2i> MakeBestGuessMove();
+
+    // Returns a safe move if there is one, otherwise a guess
+    // made with the current strategy
+    std::optional<def::Vector2i> MakeGuessMove();
+
+    /*
+    Same as MakeGuessMove but returns by the deadline: a safe move
+    is deduced first, then the probabilities are enumerated and
+    the components that are too big are sampled as long as there
+    is time, and without any time left the guess is random.
+    The result tells which of these steps the move came from.
+    */
+    BestMoveResult BestMove(std::chrono::steady_clock::time_point deadline);
+
     /*
     Returns all cells that are known to be mines
     based on the current knowledge.
     */
-    const std::unordered_set<def::Vector2i>& GetKnownMines() const;
+    const BitBoard& GetKnownMines() const;
+
+    // Returns all cells that are known to be safe, including the opened ones
+    const BitBoard& GetKnownSafes() const;
+
+    // Returns how much work the last call to AddKnowledge or AddKnowledgeBatch did
+    const InferenceStats& GetLastInferenceStats() const;
+
+    // Changes the way new sentences and cells are deduced from the knowledge base
+    void SetDeductionEngine(DeductionEngine engine);
+    DeductionEngine GetDeductionEngine() const;
+
+    void SetGuessStrategy(GuessStrategy strategy);
+    GuessStrategy GetGuessStrategy() const;
+
+    // Time the guesses can spend sampling the components of the frontier
+    // that are too big to enumerate
+    void SetSamplingBudget(std::chrono::microseconds budget);
+    std::chrono::microseconds GetSamplingBudget() const;
+
+    // Cells at most this much more likely to be a mine than the best one
+    // are considered by the InformationGain strategy
+    static constexpr double INFORMATION_SAFETY_MARGIN = 0.02;
+
+    // Random draws from the candidates before the cells outside
+    // of the frontier are counted to pick one of them
+    static constexpr int MAX_OTHER_CELL_DRAWS = 8;
 
 private:
-    void MarkCells();
+    // Same as the public ones but take an index of the cell on the board
+    void MarkMine(int index);
+    void MarkSafe(int index);
+
+    // Probabilities of mines in the cells that are not known yet
+    MineProbabilities ComputeProbabilities(std::chrono::steady_clock::time_point deadline);
+
+    // Returns the index of the cell with the lowest probability of a mine or -1
+    int GuessLowest(const MineProbabilities& probabilities, double& mineProbability);
+
+    /*
+    Chooses among the unknown cells the one with the highest score,
+    only the cells that are at most 'margin' more likely to be
+    a mine than the safest one are considered.
+    Returns the index of the cell or -1.
+    */
+    template<typename Score>
+    int GuessAmongSafest(const std::vector<double>& mineProbabilities, double margin, Score score);
+
+    // Removes the cell from the candidates of a random move by swapping it with the last one
+    void RemoveRandomCandidate(int index);
+
+    // Adds the sentence about the undetermined neighbours of an opened cell
+    void AddNeighboursSentence(const def::Vector2i& cell, int minesCount);
+
+    // Adds a sentence to the knowledge base if it is not already there
+    void AddSentence(const Sentence& sentence);
+
+    // Returns true if an equal sentence is in the knowledge base
+    bool ContainsSentence(const Sentence& sentence) const;
+
+    // Keep the lookup table of the sentences in sync with their hashes
+    void RegisterSentence(int id);
+    void UnregisterSentence(int id);
+
+    /*
+    Marks a cell in all sentences that contain it.
+    Sentences that are left without cells are retired.
+    */
+    template <class Mark>
+    void MarkInSentences(int index, Mark mark);
+
+    // Removes a sentence from the knowledge base, its id can be reused later
+    void RetireSentence(int id);
+    bool IsRetired(int id) const;
+
+    Sentence& GetSentence(int id);
+    const Sentence& GetSentence(int id) const;
+
+    // Remembers that a sentence has to be compared with its neighbours again
+    void QueueSentence(int id);
+
+    /*
+    Processes the queued sentences in rounds until none are left.
+    Each round marks the cells of the fully determined sentences
+    and applies the subtraction rule to the rest. Everything that
+    changes during a round is queued for the next one.
+    */
+    InferenceStats Propagate();
+
+    /*
+    Applies the subtraction rule to a sentence and all sentences
+    that share a cell with it.
+    */
+    void InferFrom(int id);
 
 private:
     def::Vector2i m_BoardSize;
+    int m_MinesCount;
+
+    BitBoard m_Moves;
+    BitBoard m_Safes;
+    BitBoard m_Mines;
 
-    std::unordered_set<def::Vector2i> m_Moves;
-    std::unordered_set<def::Vector2i> m_Safes;
-    std::unordered_set<def::Vector2i> m_Mines;
+    /*
+    Safe cells in the order they were found. A cell that was
+    opened after it was queued is dropped only when it reaches
+    the front, so MakeSafeMove takes constant amortized time.
+    */
+    std::deque<int> m_SafeQueue;
 
+    /*
+    Only live sentences are stored here, retired ones are replaced
+    by the last sentence. Sentences are referred to by stable ids
+    and m_Slots maps an id to the position of the sentence in m_Knowledge.
+    */
     std::vector<Sentence> m_Knowledge;
+    std::vector<int> m_KnowledgeIds;
+
+    std::vector<int> m_Slots;
+    std::vector<int> m_FreeIds;
+
+    static constexpr int RETIRED = -1;
+
+    // Sentence ids by the sentence hash, used to skip duplicate sentences
+    std::unordered_multimap<size_t, int> m_SentencesByHash;
+
+    /*
+    Ids of the sentences that contain a cell, indexed by y * width + x.
+    Sentences only lose cells when the cells are marked, and then
+    the whole list of the cell is dropped, so the index is always exact.
+    */
+    std::vector<std::vector<int>> m_CellSentences;
+
+    // Sentences that were added or changed since the last inference
+    std::vector<int> m_Dirty;
+    std::vector<bool> m_Queued;
+
+    InferenceStats m_LastInference;
+
+    FrontierSolver m_Solver;
+    EliminationSolver m_Eliminator;
+
+    DeductionEngine m_DeductionEngine = DeductionEngine::Subset;
+    GuessStrategy m_GuessStrategy = GuessStrategy::LowestProbability;
+
+    // Used for the random moves and to break ties between guesses
+    Random m_Random;
+
+    /*
+    Cells that are neither opened nor known to be mines, so a random
+    move is a single draw. m_CandidatePositions maps a board index
+    to its position in the list, or -1 if the cell was removed.
+    */
+    std::vector<int> m_RandomCandidates;
+    std::vector<int> m_CandidatePositions;
+
+    /*
+    Probability of a mine in every cell, kept between the guesses so a guess
+    only fills in the candidates. A cell that stops being a candidate gets 1
+    if it's a mine and 0 if it was opened and keeps it from then on.
+    */
+    std::vector<double> m_MineProbabilities;
 
 };
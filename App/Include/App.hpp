@@ -4,8 +4,11 @@
 
 #include "Game.hpp"
 #include "AI.hpp"
+#include "Record.hpp"
 
 #include <array>
+#include <chrono>
+#include <fstream>
 
 namespace config
 {
@@ -13,14 +16,21 @@ namespace config
     const def::Vector2i BOARD_ORIGIN(BOARD_PADDING, BOARD_PADDING);
     const def::Vector2i BOARD_SIZE(8, 8);
 
-    const std::array<std::string, 3> RULES
+    const std::array<std::string, 4> RULES
     {
         "Click a cell to reveal it.",
         "Right-click a cell to mark it as a mine.",
-        "Mark all mines successfully to win!"
+        "Mark all mines successfully to win!",
+        "Press G to change how the AI guesses."
     };
 
     constexpr int MINES_COUNT = 8;
+
+    // The AI answers within one frame, even if it has to guess roughly
+    constexpr std::chrono::milliseconds AI_MOVE_BUDGET{ 16 };
+
+    // Every game is appended to this log so it can be replayed by the Simulator
+    constexpr const char* RECORD_PATH = "Games.msg";
 }
 
 struct Rect2i
@@ -46,6 +56,9 @@ private:
 
     void DrawWithinCell(const def::Vector2i& pos, const def::Graphic& gfx);
 
+    // Creates a new game and a new AI with new seeds
+    void NewGame();
+
 private:
     bool m_ShowInstructions = true;
     
@@ -60,4 +73,17 @@ private:
 
     bool m_Lost = false;
 
+    // The mines are placed again on the first move so it never hits a mine
+    bool m_FirstMove = true;
+
+    // Chosen with the G key, a game that has begun keeps its strategy
+    // and every new AI gets this one
+    GuessStrategy m_GuessStrategy = GuessStrategy::LowestProbability;
+
+    uint64_t m_BoardSeed = 0;
+    uint64_t m_AISeed = 0;
+
+    std::ofstream m_Record;
+    GameWriter m_Writer{ m_Record };
+
 };
\ No newline at end of file
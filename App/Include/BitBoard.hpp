@@ -0,0 +1,127 @@
+#pragma once
+
+#include "Vector2D.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+/*
+Dense set of board cells where every cell is stored as a single bit.
+The cell (x, y) is stored at the bit y * width + x, so checking,
+adding and removing a cell costs one word operation and counting
+the cells costs one popcount per 64 cells.
+*/
+class BitBoard
+{
+public:
+    using Word = uint64_t;
+    static constexpr int WORD_BITS = 64;
+
+    class Iterator
+    {
+    public:
+        Iterator(const BitBoard* board, int word);
+
+        def::Vector2i operator*() const;
+
+        Iterator& operator++();
+        bool operator!=(const Iterator& other) const;
+
+    private:
+        void SkipEmptyWords();
+
+    private:
+        const BitBoard* m_Board;
+
+        int m_Word;
+        Word m_Bits;
+
+    };
+
+    BitBoard() = default;
+    BitBoard(const def::Vector2i& boardSize);
+
+    int Index(const def::Vector2i& cell) const;
+    def::Vector2i Cell(int index) const;
+
+    bool Contains(int index) const;
+    bool Contains(const def::Vector2i& cell) const;
+
+    void Insert(int index);
+    void Insert(const def::Vector2i& cell);
+
+    void Erase(int index);
+    void Erase(const def::Vector2i& cell);
+
+    // Returns the number of cells in the set
+    int Count() const;
+
+    Iterator begin() const;
+    Iterator end() const;
+
+private:
+    def::Vector2i m_BoardSize;
+    std::vector<Word> m_Words;
+
+};
+
+/*
+Sparse set of board cells that uses the same bit layout as BitBoard
+but only stores the words that have at least one cell in them.
+The words are kept sorted by their position on the board, so
+sets with the same cells always have the same representation.
+
+Sentences only ever cover a few neighbouring cells so a dense
+board per sentence would waste both memory and time.
+*/
+class CellSet
+{
+public:
+    struct Chunk
+    {
+        int word;
+        BitBoard::Word bits;
+
+        bool operator==(const Chunk& other) const = default;
+    };
+
+    bool Contains(int index) const;
+
+    void Insert(int index);
+
+    // Returns false if the cell was not in the set
+    bool Erase(int index);
+
+    // Returns the number of cells in the set
+    int Size() const;
+    bool Empty() const;
+
+    // Returns the smallest index in a non-empty set
+    int First() const;
+
+    bool IsSubsetOf(const CellSet& other) const;
+
+    // Returns the cells of this set that are not in the other set
+    CellSet Difference(const CellSet& other) const;
+
+    bool operator==(const CellSet& other) const = default;
+
+    // The representation is canonical so equal sets have equal hashes
+    size_t Hash() const;
+
+    // Calls f(index) for each cell in the set
+    template <class F>
+    void ForEach(F&& f) const
+    {
+        for (const auto& chunk : m_Chunks)
+        {
+            for (BitBoard::Word bits = chunk.bits; bits != 0; bits &= bits - 1)
+                f(chunk.word * BitBoard::WORD_BITS + std::countr_zero(bits));
+        }
+    }
+
+private:
+    std::vector<Chunk> m_Chunks;
+
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Frontier.hpp"
+
+#include <cstdint>
+#include <vector>
+
+struct ForcedCells
+{
+    // Board indices of the cells
+    std::vector<int> safes;
+    std::vector<int> mines;
+};
+
+/*
+Deduces cells by treating the constraints of a component as a system
+of linear equations over the integers and reducing it to the row echelon form.
+
+Each row of the reduced system is a sum of some sentences with
+integer factors, so the deductions that need three or more sentences
+at once show up in a single row. A cell is forced when its value follows
+from the bounds of the row: every other cell is either 0 or 1 so
+the sum of the rest of the row can only be within a known range.
+*/
+class EliminationSolver
+{
+public:
+    ForcedCells Solve(const std::vector<FrontierComponent>& components);
+
+private:
+    struct Row
+    {
+        // Columns with a non-zero coefficient, one bit per column
+        std::vector<uint64_t> support;
+        std::vector<int64_t> coefficients;
+        int64_t value;
+    };
+
+    void Reduce(std::vector<Row>& rows, int columnsCount);
+    void Deduce(const FrontierComponent& component, const std::vector<Row>& rows, ForcedCells& forced);
+
+    // Sets rowA = a * rowA - b * rowB and divides it by the gcd of its numbers
+    static void Combine(Row& rowA, const Row& rowB, int64_t a, int64_t b);
+
+};
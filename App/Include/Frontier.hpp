@@ -0,0 +1,150 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+struct Sentence;
+
+/*
+A group of frontier cells that share sentences only with each other,
+so the mines in it can be placed independently from other groups.
+Cells are stored as board indices and the constraints refer
+to them by their position in 'cells'.
+*/
+struct FrontierComponent
+{
+    struct Constraint
+    {
+        std::vector<int> vars;
+        int minesCount;
+    };
+
+    std::vector<int> cells;
+    std::vector<Constraint> constraints;
+};
+
+/*
+Numbers of the mine layouts of a component that agree
+with all of its constraints, grouped by the number of mines.
+*/
+struct ComponentLayouts
+{
+    // layouts[k] - number of layouts with k mines
+    std::vector<double> layouts;
+
+    // mines[k][i] - number of layouts with k mines where the cell i is a mine
+    std::vector<std::vector<double>> mines;
+
+    // False if the enumeration was cut off before it visited every layout
+    bool complete = true;
+
+    // True if the numbers are estimated from random layouts,
+    // they are then scaled by an unknown factor
+    bool sampled = false;
+
+    // True if the deadline of the caller stopped the enumeration or the sampling
+    bool timedOut = false;
+
+    // True if the sampling budget ran out before all the samples were taken,
+    // the next call samples the component again instead of reusing the result
+    bool cutShort = false;
+};
+
+struct MineProbabilities
+{
+    // Board indices of the frontier cells and the probability
+    // of a mine in each of them
+    std::vector<int> cells;
+    std::vector<double> probabilities;
+
+    // Probability of a mine in any unknown cell that is not on the frontier
+    double otherProbability = 0.0;
+    int otherCount = 0;
+
+    // False if some component was too big to be enumerated completely
+    bool exact = true;
+
+    // True if some component was estimated by sampling
+    bool sampled = false;
+
+    // True if the deadline stopped the work on some component early,
+    // so its probabilities are rougher than usual
+    bool timedOut = false;
+};
+
+/*
+Computes exact probabilities of mines in the unknown cells.
+
+The frontier (cells that appear in sentences) is split into independent
+components and all consistent layouts of each component are enumerated
+with backtracking. Then the components are combined, weighting every
+total number of mines on the frontier by the number of ways
+to place the remaining mines in the rest of the unknown cells.
+
+Components whose enumeration is cut off are estimated
+with LayoutSampler within the sampling budget instead.
+*/
+class FrontierSolver
+{
+public:
+    FrontierSolver(int cellsCount);
+
+    // Stop enumerating a component after visiting that many assignments
+    static constexpr int64_t MAX_ENUMERATION_STEPS = 1 << 22;
+
+    // Components with fewer cells are enumerated on the calling thread
+    static constexpr int PARALLEL_MIN_CELLS = 16;
+
+    // Components with more cells are split into pieces by fixing
+    // the values of a few cells, so several workers can enumerate them
+    static constexpr int SPLIT_MIN_CELLS = 24;
+    static constexpr int MAX_SPLIT_DEPTH = 8;
+
+    // Sampling of a component stops after that many samples even if
+    // there is time left, so the estimates usually don't depend on the speed
+    static constexpr int64_t MAX_SAMPLES = 1 << 16;
+
+    static constexpr std::chrono::microseconds DEFAULT_SAMPLING_BUDGET{ 20000 };
+
+    // Stops enumerating and sampling at the deadline, the results that were
+    // cut off by it are not reused by the next calls
+    MineProbabilities Solve(const std::vector<Sentence>& knowledge, int unknownCount, int minesLeft,
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max());
+
+    std::vector<FrontierComponent> SplitFrontier(const std::vector<Sentence>& knowledge);
+
+    /*
+    Enumerates the layouts of the components with at most 'maxMines' mines
+    in each of them. The components are enumerated in parallel on the shared
+    thread pool. Components with the same shape give the same result,
+    so results are cached by the shape and reused within and across calls.
+    */
+    std::vector<const ComponentLayouts*> Enumerate(const std::vector<FrontierComponent>& components, int maxMines,
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max());
+
+    // Time given to all components that are sampled in one call
+    void SetSamplingBudget(std::chrono::microseconds budget);
+    std::chrono::microseconds GetSamplingBudget() const;
+
+private:
+    static std::vector<int> MakeKey(const FrontierComponent& component, int maxMines);
+
+    struct KeyHash
+    {
+        size_t operator()(const std::vector<int>& key) const;
+    };
+
+    // Position of a frontier cell among the variables, indexed by board index
+    std::vector<int> m_Variables;
+
+    // m_LogFactorials[n] = ln(n!), weights of the numbers of mines on the frontier
+    std::vector<double> m_LogFactorials;
+
+    std::unordered_map<std::vector<int>, ComponentLayouts, KeyHash> m_Cache;
+
+    std::chrono::microseconds m_SamplingBudget = DEFAULT_SAMPLING_BUDGET;
+
+};
@@ -1,6 +1,33 @@
 ﻿#pragma once
 
 #include "Vector2D.hpp"
+#include "Random.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef MINESWEEPER_PACKED_CELLS
+
+/*
+    The whole cell in one byte, so much bigger boards fit in the caches.
+    The fields are used the same way as in the wide cell
+    but their addresses can't be taken.
+*/
+struct Cell
+{
+    uint8_t isFlagged : 1 = false;
+    uint8_t isMine : 1 = false;
+    uint8_t isRevealed : 1 = false;
+
+    uint8_t nearbyMinesCount : 4 = 0;
+};
+
+static_assert(sizeof(Cell) == 1);
+
+#else
 
 struct Cell
 {
@@ -11,17 +38,60 @@ struct Cell
     int nearbyMinesCount = 0;
 };
 
+#endif
+
+static_assert(std::is_trivially_copyable_v<Cell>);
+
 class Minesweeper
 {
 public:
-    Minesweeper(const def::Vector2i& boardSize, int minesCount);
-    ~Minesweeper();
+    // The same seed of the generator always gives the same layout of mines
+    Minesweeper(const def::Vector2i& boardSize, int minesCount, Random random = Random());
+
+    // Creates the board with the given mines, mines[y * width + x]
+    // is true if the cell has a mine, used to replay recorded games
+    Minesweeper(const def::Vector2i& boardSize, const std::vector<bool>& mines);
+
+    // Games are only copied explicitly with Clone, so a copy
+    // of a big board never happens by accident
+    Minesweeper(Minesweeper&&) noexcept = default;
+    Minesweeper& operator=(Minesweeper&&) noexcept = default;
+    Minesweeper& operator=(const Minesweeper&) = delete;
+
+    // Returns an independent copy of the game, the cells are copied
+    // with a single memcpy so states can be forked cheaply
+    Minesweeper Clone() const;
+
+    /*
+        Places the mines again so the cell and its neighbours
+        have no mines, used to make the first click always safe.
+        If there are too few cells for that only the cell itself
+        is kept free, and if the board is all mines nothing is.
+    */
+    void PlaceMines(const def::Vector2i& safeCell);
+
+    /*
+        Opens the cell and returns all cells that were opened with their
+        numbers. If the cell has no mines around it, its neighbours are opened
+        too and so on, the whole empty region is filled span by span
+        without recursion. Flagged cells are never opened.
+        Returns nothing if the cell is a mine or already open.
+    */
+    std::vector<std::pair<def::Vector2i, int>> Reveal(const def::Vector2i& cell);
+
+    // Places or removes a flag, open cells can't be flagged
+    void SetFlag(const def::Vector2i& cell, bool flagged);
+    void ToggleFlag(const def::Vector2i& cell);
 
-    // Returns a state of the cell
-    Cell& GetCell(const def::Vector2i& cell);
+    const def::Vector2i& GetBoardSize() const;
+    int GetMinesCount() const;
+
+    // Returns a state of the cell, it can only be changed
+    // through the methods above so the counters stay right
     const Cell& GetCell(const def::Vector2i& cell) const;
     
     // Checks if the player has flagged all mines
+    // and every other cell is either open or flagged
     bool Won() const;
 
     /*
@@ -31,12 +101,48 @@ public:
     */
     int CountNearbyMines(const def::Vector2i& cell) const;
 
+private:
+    Minesweeper(const Minesweeper& other);
+
+    /*
+        Chooses the cells of the mines with a partial Fisher-Yates shuffle
+        of the allowed cells, so it takes linear time at any density.
+    */
+    void PlaceMinesExcept(const std::vector<int>& excluded);
+
+    // Removes all mines and closes all cells except the border, keeps the flags
+    void ClearBoard();
+
+    // Updates the counters and the numbers of the cells after placing the mines
+    void FinishPlacement();
+
+    // Sums the mines in every 3x3 box in two passes,
+    // first along the rows and then along the columns
+    void CountAllNearbyMines();
+
+    // Position of the cell on the padded board
+    int Index(const def::Vector2i& cell) const;
+    def::Vector2i Position(int index) const;
+
 private:
     def::Vector2i m_BoardSize;
 
-    // Here true stands for a mine and false stands for a no mine
-    Cell* m_Board;
+    /*
+        The board has a border of one cell on each side that has no mines
+        and is revealed, so the neighbours of any cell can be visited
+        without checking the bounds. Rows are m_Stride cells long.
+    */
+    std::unique_ptr<Cell[]> m_Board;
+
+    int m_Stride;
+    int m_PaddedCount;
 
     int m_MinesCount;
 
+    // Counters for Won, kept up to date by every change of a cell
+    int m_FlaggedMines = 0;
+    int m_OpenOrFlagged = 0;
+
+    Random m_Random;
+
 };
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+
+/*
+Pseudo random number generator (xoshiro256**).
+
+Every game and every AI owns its own generator, so games that are
+played at the same time on different threads don't share any state
+and the same seed always gives the same sequence of numbers.
+*/
+class Random
+{
+public:
+    // Seeds the generator from the random device of the system
+    Random();
+
+    // The state is filled from the seed with splitmix64,
+    // so close seeds give unrelated sequences
+    explicit Random(uint64_t seed);
+
+    uint64_t Next();
+
+    // Returns a uniformly distributed number in [0, bound)
+    int NextInt(int bound);
+
+    // Returns a uniformly distributed number in [0, 1)
+    double NextDouble();
+
+    // Returns a new generator that is seeded from this one
+    Random Split();
+
+    static uint64_t SplitMix(uint64_t& state);
+
+private:
+    uint64_t m_State[4];
+
+};
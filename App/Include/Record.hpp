@@ -0,0 +1,129 @@
+#pragma once
+
+#include "Game.hpp"
+#include "AI.hpp"
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+/*
+Binary log of played games, used to reproduce the moves of the AI.
+
+Every game starts with its own header, so logs can simply be concatenated:
+
+    "MSG" version
+    board seed, AI seed, width, height, mines count, deduction engine, guess strategy
+    mines: width * height bits, row by row, lowest bit first
+    moves: kind, x, y
+    end: 0xFF, result
+
+All numbers except the version and the bytes of the mines
+are unsigned LEB128, so a move usually takes three bytes.
+*/
+
+enum class MoveKind : uint8_t
+{
+    // The player opened a cell
+    Open,
+
+    // The AI opened a cell it knew to be safe
+    SafeMove,
+
+    // The AI opened a cell that it guessed
+    GuessMove,
+
+    SetFlag,
+    ClearFlag
+};
+
+enum class GameResult : uint8_t
+{
+    Unfinished,
+    Won,
+    Lost
+};
+
+struct GameHeader
+{
+    uint64_t boardSeed = 0;
+    uint64_t aiSeed = 0;
+
+    def::Vector2i boardSize;
+    int minesCount = 0;
+
+    DeductionEngine engine = DeductionEngine::Subset;
+    GuessStrategy strategy = GuessStrategy::LowestProbability;
+
+    // mines[y * width + x] is true if the cell has a mine
+    std::vector<bool> mines;
+};
+
+struct MoveRecord
+{
+    MoveKind kind;
+    def::Vector2i cell;
+};
+
+class GameWriter
+{
+public:
+    GameWriter(std::ostream& stream);
+
+    // Writes the header with the layout of the mines of the game,
+    // the flags that are already placed are written as moves
+    void BeginGame(const Minesweeper& game, uint64_t boardSeed, uint64_t aiSeed, DeductionEngine engine, GuessStrategy strategy);
+
+    void AddMove(MoveKind kind, const def::Vector2i& cell);
+    void EndGame(GameResult result);
+
+    bool InGame() const;
+
+private:
+    void WriteNumber(uint64_t number);
+
+private:
+    std::ostream& m_Stream;
+    bool m_InGame = false;
+
+};
+
+/*
+Reads the games one move at a time, so logs of any size
+can be replayed without loading them into memory.
+*/
+class GameReader
+{
+public:
+    GameReader(std::istream& stream);
+
+    // Reads the header of the next game, skipping the moves
+    // of the current one that were not read.
+    // Returns false at the end of the log or if it's corrupted
+    bool NextGame(GameHeader& header);
+
+    // Returns false at the end of the game, then the result is known
+    bool NextMove(MoveRecord& move);
+
+    GameResult GetResult() const;
+
+    // True if the log ended in the middle of a game or has invalid data
+    bool IsCorrupted() const;
+
+private:
+    bool ReadNumber(uint64_t& number);
+    bool ReadByte(uint8_t& byte);
+
+private:
+    std::istream& m_Stream;
+
+    // Size of the board of the current game, to check the moves
+    def::Vector2i m_BoardSize;
+
+    bool m_InGame = false;
+    bool m_Corrupted = false;
+
+    GameResult m_Result = GameResult::Unfinished;
+
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Frontier.hpp"
+#include "Random.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+/*
+Estimates the layouts of a component that is too big to be enumerated.
+
+Samples are drawn with sequential importance sampling: the cells are
+assigned one by one and a cell that can still be either a mine or safe
+gets a random value, a cell that can be only one of them gets that value.
+Every complete layout is weighted by 2 to the number of random choices,
+so the weighted counts are unbiased estimates of the numbers of layouts.
+
+LANES samples are drawn at once: the value of a cell is a word with
+a bit per sample and the numbers of mines in the constraints are kept
+as bit planes, so a cell is checked against its constraints in all
+samples with a few AND and OR operations.
+*/
+class LayoutSampler
+{
+public:
+    static constexpr int LANES = 64;
+
+    LayoutSampler(const FrontierComponent& component, int maxMines, uint64_t seed);
+
+    // Draws samples until the deadline or until there are at least 'maxSamples' of them
+    void Run(std::chrono::steady_clock::time_point deadline, int64_t maxSamples);
+
+    // Estimated layouts, scaled by the same factor for every number of mines
+    ComponentLayouts GetLayouts() const;
+
+    int64_t GetSamplesCount() const;
+
+private:
+    void SampleBatch();
+
+    // Lanes where the number of mines of the constraint is less than 'bound'
+    uint64_t LessThan(int constraint, int bound) const;
+
+    void AddMines(int constraint, uint64_t lanes);
+
+private:
+    const FrontierComponent& m_Component;
+    int m_MaxMines;
+
+    Random m_Random;
+
+    // Order in which the cells are assigned, so constraints become tight early
+    std::vector<int> m_Order;
+    std::vector<std::vector<int>> m_VarConstraints;
+
+    // Bit planes of the numbers of mines of the constraints,
+    // the planes of the constraint c start at m_PlanesStart[c]
+    std::vector<int> m_PlanesStart;
+    std::vector<uint64_t> m_Planes;
+    std::vector<int> m_Unassigned;
+
+    // Values of the cells in the current batch, a bit per lane
+    std::vector<uint64_t> m_Values;
+
+    // Sums of the weights of the samples by the number of mines
+    std::vector<double> m_Layouts;
+    std::vector<std::vector<double>> m_Mines;
+
+    // The weights are 2^(choices - m_Reference), so big components don't overflow
+    int m_Reference = -1;
+
+    int64_t m_SamplesCount = 0;
+
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+A set of tasks that can be waited for together.
+Several groups can run on the same pool at once.
+*/
+class TaskGroup
+{
+public:
+    friend class ThreadPool;
+
+    bool Done() const;
+
+private:
+    std::atomic<int> m_Pending = 0;
+
+};
+
+/*
+Pool of worker threads with a queue per worker.
+A worker takes its own tasks from the back of its queue
+and when it runs out of them it steals the oldest tasks
+from the front of the other queues, so big tasks that were
+submitted first are split between the workers.
+*/
+class ThreadPool
+{
+public:
+    using Task = std::function<void()>;
+
+    ThreadPool(int threadsCount);
+    ~ThreadPool();
+
+    // Pool that is shared by everything in the process,
+    // it has a worker for each hardware thread except the current one
+    static ThreadPool& Shared();
+
+    int GetThreadsCount() const;
+
+    void Submit(TaskGroup& group, Task task);
+
+    // Runs the tasks of the group on the calling thread until the group is done,
+    // tasks of other groups are left to the workers so a waiting caller
+    // is never held up by work it didn't ask for
+    void Wait(TaskGroup& group);
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<std::pair<TaskGroup*, Task>> tasks;
+    };
+
+    void WorkerLoop(int index);
+
+    // Runs one task from the queue of 'index' or steals one from another
+    // queue, only a task of 'group' if it's given, returns false if none is found
+    bool RunTask(int index, const TaskGroup* group = nullptr);
+
+private:
+    std::vector<std::unique_ptr<Queue>> m_Queues;
+    std::vector<std::thread> m_Threads;
+
+    std::atomic<int> m_Queued = 0;
+    std::atomic<int> m_NextQueue = 0;
+    std::atomic<bool> m_Stop = false;
+
+    std::mutex m_SleepMutex;
+    std::condition_variable m_WakeUp;
+
+};
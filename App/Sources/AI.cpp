@@ -1,16 +1,21 @@
 ﻿#include "../Include/AI.hpp"
 
+#include <cmath>
+#include <numeric>
 #include <ranges>
 
-Sentence::Sentence(const std::unordered_set<def::Vector2i> cells, int minesCount)
-    : cells(cells), minesCount(minesCount) {}
+Sentence::Sentence(const CellSet& cells, int minesCount)
+    : cells(cells), minesCount(minesCount)
+{
+    UpdateHash();
+}
 
 bool Sentence::operator==(const Sentence& other) const
 {
     return minesCount == other.minesCount && cells == other.cells;
 }
 
-std::unordered_set<def::Vector2i> Sentence::GetKnownMines() const
+CellSet Sentence::GetKnownMines() const
 {
     /*
     Some of the cells that we have in our sentence
@@ -20,13 +25,13 @@ std::unordered_set<def::Vector2i> Sentence::GetKnownMines() const
     but otherwise we can't tell anything else so just return empty set.
     */
 
-    if (cells.size() == minesCount)
+    if (cells.Size() == minesCount)
         return cells;
 
     return {};
 }
 
-std::unordered_set<def::Vector2i> Sentence::GetKnownSafes() const
+CellSet Sentence::GetKnownSafes() const
 {
     // If the number of mines among these cells is 0 then we know
     // for sure that there are no mines at all (logical, huh?).
@@ -37,62 +42,109 @@ std::unordered_set<def::Vector2i> Sentence::GetKnownSafes() const
     return {};
 }
 
-void Sentence::MarkMine(const def::Vector2i& cell)
+bool Sentence::MarkMine(int cell)
 {
     // Marks a cell as a mine, and updates all knowledge
     // to mark that cell as a mine as well.
 
-    const auto it = std::ranges::find(cells, cell);
-    
-    if (it == cells.end())
-        return;
+    if (!cells.Erase(cell))
+        return false;
 
-    cells.erase(it);
     minesCount--;
+    UpdateHash();
+
+    return true;
 }
 
-void Sentence::MarkSafe(const def::Vector2i& cell)
+bool Sentence::MarkSafe(int cell)
 {
     // Marks a cell as safe, and updates all knowledge
     // to mark that cell as safe as well.
 
-    const auto it = std::ranges::find(cells, cell);
-    
-    if (it == cells.end())
-        return;
+    if (!cells.Erase(cell))
+        return false;
 
-    cells.erase(it);
+    UpdateHash();
+    return true;
 }
 
-MinesweeperAI::MinesweeperAI(const def::Vector2i& boardSize)
-    : m_BoardSize(boardSize) {}
+void Sentence::UpdateHash()
+{
+    hash = cells.Hash() ^ (size_t(minesCount) * 0x9E3779B97F4A7C15ULL);
+}
 
-void MinesweeperAI::MarkMine(const def::Vector2i& cell)
+MinesweeperAI::MinesweeperAI(const def::Vector2i& boardSize, int minesCount, Random random)
+    : m_BoardSize(boardSize), m_MinesCount(minesCount)
+    , m_Moves(boardSize), m_Safes(boardSize), m_Mines(boardSize)
+    , m_CellSentences(boardSize.x * boardSize.y), m_Solver(boardSize.x * boardSize.y), m_Random(random)
+    , m_RandomCandidates(boardSize.x * boardSize.y), m_CandidatePositions(boardSize.x * boardSize.y)
+    , m_MineProbabilities(boardSize.x * boardSize.y, 0.0)
 {
-    m_Mines.insert(cell);
+    std::iota(m_RandomCandidates.begin(), m_RandomCandidates.end(), 0);
+    std::iota(m_CandidatePositions.begin(), m_CandidatePositions.end(), 0);
+}
 
-    for (auto& sentence : m_Knowledge)
-        sentence.MarkMine(cell);
+void MinesweeperAI::MarkMine(const def::Vector2i& cell)
+{
+    MarkMine(m_Mines.Index(cell));
 }
 
 void MinesweeperAI::MarkSafe(const def::Vector2i& cell)
 {
-    m_Safes.insert(cell);
+    MarkSafe(m_Safes.Index(cell));
+}
+
+void MinesweeperAI::MarkMine(int index)
+{
+    m_Mines.Insert(index);
+    RemoveRandomCandidate(index);
+
+    MarkInSentences(index, &Sentence::MarkMine);
+}
+
+void MinesweeperAI::MarkSafe(int index)
+{
+    if (!m_Safes.Contains(index) && !m_Moves.Contains(index))
+        m_SafeQueue.push_back(index);
 
-    for (auto& sentence : m_Knowledge)
-        sentence.MarkSafe(cell);
+    m_Safes.Insert(index);
+
+    MarkInSentences(index, &Sentence::MarkSafe);
 }
 
 void MinesweeperAI::AddKnowledge(const def::Vector2i& cell, int minesCount)
 {
-    m_Moves.insert(cell);
-    MarkSafe(cell);
+    std::pair<def::Vector2i, int> observation(cell, minesCount);
+    AddKnowledgeBatch({ &observation, 1 });
+}
 
+void MinesweeperAI::AddKnowledgeBatch(std::span<const std::pair<def::Vector2i, int>> cells)
+{
+    // Mark all cells first, so the sentences of the batch
+    // don't contain the cells that are opened in the same batch
+    for (const auto& [cell, minesCount] : cells)
+    {
+        m_Moves.Insert(cell);
+        RemoveRandomCandidate(m_Moves.Index(cell));
+
+        MarkSafe(cell);
+    }
+
+    for (const auto& [cell, minesCount] : cells)
+        AddNeighboursSentence(cell, minesCount);
+
+    // Mark any additional cells as safe or as mines and add any new
+    // sentences until nothing else can be concluded from the knowledge base
+    m_LastInference = Propagate();
+}
+
+void MinesweeperAI::AddNeighboursSentence(const def::Vector2i& cell, int minesCount)
+{
     // Get neighbouring cells but exclude the safe ones
     // and decrement the "count" if the cell is known to be mine
 
     static const def::Vector2i ORIGIN(0, 0);
-    std::unordered_set<def::Vector2i> undetermined;
+    CellSet undetermined;
 
     def::Vector2i offset;
     for (offset.y = -1; offset.y <= 1; offset.y++)
@@ -105,13 +157,15 @@ void MinesweeperAI::AddKnowledge(const def::Vector2i& cell, int minesCount)
 
             if (ORIGIN <= neigh && neigh < m_BoardSize)
             {
-                bool isSafe = m_Safes.contains(neigh);
-                bool isMine = m_Mines.contains(neigh);
+                int index = m_Safes.Index(neigh);
+
+                bool isSafe = m_Safes.Contains(index);
+                bool isMine = m_Mines.Contains(index);
 
                 // If the state of the neighbour is undetermined then
                 // add it to the new sentence
                 if (!isSafe && !isMine)
-                    undetermined.insert(neigh);
+                    undetermined.Insert(index);
 
                 // And decrease the number of mines if the cell is known to be mine
                 if (isMine)
@@ -119,126 +173,604 @@ void MinesweeperAI::AddKnowledge(const def::Vector2i& cell, int minesCount)
             }
         }
 
-    if (!undetermined.empty())
+    // Add a new sentence to the AI's knowledge base based
+    // on the value of 'cell' and 'count'
+    if (!undetermined.Empty())
+        AddSentence(Sentence(undetermined, minesCount));
+}
+    
+std::optional<def::Vector2i> MinesweeperAI::MakeSafeMove()
+{
+    while (!m_SafeQueue.empty())
     {
-        // Add a new sentence to the AI's knowledge base based
-        // on the value of 'cell' and 'count'
-        Sentence newSentence(undetermined, minesCount);
+        int move = m_SafeQueue.front();
+
+        if (!m_Moves.Contains(move))
+            return m_Safes.Cell(move);
+
+        m_SafeQueue.pop_front();
+    }
+
+    return std::nullopt;
+}
+
+std::optional<def::Vector2i> MinesweeperAI::MakeRandomMove()
+{
+    if (m_RandomCandidates.empty())
+        return std::nullopt;
+
+    return m_Moves.Cell(m_RandomCandidates[m_Random.NextInt(int(m_RandomCandidates.size()))]);
+}
+
+void MinesweeperAI::RemoveRandomCandidate(int index)
+{
+    int position = m_CandidatePositions[index];
+
+    if (position == -1)
+        return;
+
+    // Move the last candidate into the place of the removed one
+    int last = m_RandomCandidates.back();
+
+    m_RandomCandidates[position] = last;
+    m_CandidatePositions[last] = position;
+
+    m_RandomCandidates.pop_back();
+    m_CandidatePositions[index] = -1;
+
+    m_MineProbabilities[index] = m_Mines.Contains(index) ? 1.0 : 0.0;
+}
+
+void MinesweeperAI::AddSentence(const Sentence& sentence)
+{
+    if (sentence.cells.Empty() || ContainsSentence(sentence))
+        return;
 
-        if (!newSentence.cells.empty() && !Vector_Contains(m_Knowledge, newSentence))
-            m_Knowledge.push_back(newSentence);
+    // Reuse the ids of retired sentences so the per-id tables
+    // only grow with the number of live sentences
+    int id;
+
+    if (m_FreeIds.empty())
+    {
+        id = m_Slots.size();
+        m_Slots.push_back(0);
+    }
+    else
+    {
+        id = m_FreeIds.back();
+        m_FreeIds.pop_back();
     }
 
-    // Mark any additional cells as safe or as mines
-    // if it can be concluded based on the AI's knowledge base
-    MarkCells();
+    m_Slots[id] = m_Knowledge.size();
+    m_Knowledge.push_back(sentence);
+    m_KnowledgeIds.push_back(id);
 
-    // Add any new sentences to the AI's knowledge base
-    // if they can be inferred from existing knowledge
-    std::vector<Sentence> newSentences;
+    RegisterSentence(id);
 
-    for (const auto& sentence1 : m_Knowledge)
-        for (const auto& sentence2 : m_Knowledge)
+    sentence.cells.ForEach([&](int cell) { m_CellSentences[cell].push_back(id); });
+
+    QueueSentence(id);
+}
+
+bool MinesweeperAI::ContainsSentence(const Sentence& sentence) const
+{
+    const auto [first, last] = m_SentencesByHash.equal_range(sentence.hash);
+
+    for (auto it = first; it != last; it++)
+    {
+        if (GetSentence(it->second) == sentence)
+            return true;
+    }
+
+    return false;
+}
+
+void MinesweeperAI::RegisterSentence(int id)
+{
+    m_SentencesByHash.emplace(GetSentence(id).hash, id);
+}
+
+void MinesweeperAI::UnregisterSentence(int id)
+{
+    const auto [first, last] = m_SentencesByHash.equal_range(GetSentence(id).hash);
+
+    for (auto it = first; it != last; it++)
+    {
+        if (it->second == id)
+        {
+            m_SentencesByHash.erase(it);
+            return;
+        }
+    }
+}
+
+template <class Mark>
+void MinesweeperAI::MarkInSentences(int index, Mark mark)
+{
+    // The cell is removed from every sentence that contains it
+    // so nothing will be indexed by it anymore
+    std::vector<int> sentences = std::move(m_CellSentences[index]);
+    m_CellSentences[index].clear();
+
+    for (int id : sentences)
+    {
+        // The hash of the sentence changes so it has to be registered again
+        UnregisterSentence(id);
+
+        Sentence& sentence = GetSentence(id);
+        (sentence.*mark)(index);
+
+        // Nothing can be inferred from a sentence without cells
+        if (sentence.cells.Empty())
         {
-            // We don't compare a sentence with itself
-            if (sentence1.minesCount < 0 || sentence2.minesCount < 0 || sentence1 == sentence2)
+            RetireSentence(id);
+            continue;
+        }
+
+        RegisterSentence(id);
+        QueueSentence(id);
+    }
+}
+
+void MinesweeperAI::RetireSentence(int id)
+{
+    // Move the last sentence into the place of the retired one
+    // and update the slot of the moved sentence
+    int slot = m_Slots[id];
+    int lastId = m_KnowledgeIds.back();
+
+    if (lastId != id)
+    {
+        m_Knowledge[slot] = std::move(m_Knowledge.back());
+        m_KnowledgeIds[slot] = lastId;
+        m_Slots[lastId] = slot;
+    }
+
+    m_Knowledge.pop_back();
+    m_KnowledgeIds.pop_back();
+
+    m_Slots[id] = RETIRED;
+    m_FreeIds.push_back(id);
+}
+
+bool MinesweeperAI::IsRetired(int id) const
+{
+    return m_Slots[id] == RETIRED;
+}
+
+Sentence& MinesweeperAI::GetSentence(int id)
+{
+    return m_Knowledge[m_Slots[id]];
+}
+
+const Sentence& MinesweeperAI::GetSentence(int id) const
+{
+    return m_Knowledge[m_Slots[id]];
+}
+
+void MinesweeperAI::QueueSentence(int id)
+{
+    if (id >= int(m_Queued.size()))
+        m_Queued.resize(id + 1);
+
+    if (!m_Queued[id])
+    {
+        m_Queued[id] = true;
+        m_Dirty.push_back(id);
+    }
+}
+
+InferenceStats MinesweeperAI::Propagate()
+{
+    InferenceStats stats;
+
+    std::vector<int> round;
+
+    while (!m_Dirty.empty())
+    {
+        // Everything that is queued while we are processing
+        // the current round goes to the next one
+        round.swap(m_Dirty);
+        m_Dirty.clear();
+
+        for (int id : round)
+            m_Queued[id] = false;
+
+        stats.rounds++;
+        stats.sentencesTouched += round.size();
+
+        // Mark the cells of the sentences that are fully determined,
+        // it changes other sentences so they will be queued again
+        for (int id : round)
+        {
+            if (IsRetired(id))
                 continue;
 
-            if (UnorderedSet_IsSubset(sentence2.cells, sentence1.cells))
+            CellSet safes = GetSentence(id).GetKnownSafes();
+            CellSet mines = GetSentence(id).GetKnownMines();
+
+            safes.ForEach([&](int safe) { MarkSafe(safe); });
+            mines.ForEach([&](int mine) { MarkMine(mine); });
+        }
+
+        // The subset rule runs for both engines, the reduced system
+        // alone can't always bound a cell that two sentences force
+        for (int id : round)
+            InferFrom(id);
+
+        // The elimination looks at the whole frontier at once
+        // so run it only when the simple rules can't find anything else
+        if (m_DeductionEngine == DeductionEngine::Elimination && m_Dirty.empty())
+        {
+            ForcedCells forced = m_Eliminator.Solve(m_Solver.SplitFrontier(m_Knowledge));
+            stats.eliminations++;
+
+            for (int safe : forced.safes)
             {
-                int newCount = sentence2.minesCount - sentence1.minesCount;
+                if (!m_Safes.Contains(safe))
+                    MarkSafe(safe);
+            }
 
-                // Ensure that the difference between the number
-                // of mines isn't negative
-                if (newCount >= 0)
-                {
-                    std::unordered_set<def::Vector2i> newCells;
-                    newCells.reserve(sentence2.cells.size() - sentence1.cells.size());
-                    
-                    for (const auto& cell : sentence2.cells)
+            for (int mine : forced.mines)
+            {
+                if (!m_Mines.Contains(mine))
+                    MarkMine(mine);
+            }
+        }
+    }
+
+    return stats;
+}
+
+void MinesweeperAI::InferFrom(int id)
+{
+    if (IsRetired(id))
+        return;
+
+    // Copy the sentence because the knowledge base
+    // can grow while we are deriving new sentences from it
+    Sentence sentence = GetSentence(id);
+
+    if (sentence.minesCount < 0)
+        return;
+
+    // Only the sentences that share a cell with this one
+    // can be a subset or a superset of it
+    std::vector<int> candidates;
+
+    sentence.cells.ForEach([&](int cell)
+        {
+            for (int other : m_CellSentences[cell])
+            {
+                if (other != id)
+                    candidates.push_back(other);
+            }
+        });
+
+    std::ranges::sort(candidates);
+    const auto [first, last] = std::ranges::unique(candidates);
+    candidates.erase(first, last);
+
+    for (int other : candidates)
+    {
+        const Sentence& otherSentence = GetSentence(other);
+
+        if (otherSentence.minesCount < 0 || otherSentence == sentence)
+            continue;
+
+        // Subtract the smaller sentence from the bigger one,
+        // see "Subtraction rule" in README.md
+        const Sentence* subset = &sentence;
+        const Sentence* superset = &otherSentence;
+
+        if (!subset->cells.IsSubsetOf(superset->cells))
+        {
+            std::swap(subset, superset);
+
+            if (!subset->cells.IsSubsetOf(superset->cells))
+                continue;
+        }
+
+        int newCount = superset->minesCount - subset->minesCount;
+
+        // Ensure that the difference between the number
+        // of mines isn't negative
+        if (newCount >= 0)
+        {
+            CellSet newCells = superset->cells.Difference(subset->cells);
+
+            // Adding a sentence can reallocate the knowledge base
+            // so 'otherSentence' must not be used after that
+            AddSentence(Sentence(newCells, newCount));
+        }
+    }
+}
+
+std::optional<def::Vector2i> MinesweeperAI::MakeBestGuessMove()
+{
+    if (auto move = MakeSafeMove())
+        return move;
+
+    if (m_RandomCandidates.empty())
+        return std::nullopt;
+
+    double mineProbability;
+    int bestCell = GuessLowest(ComputeProbabilities(std::chrono::steady_clock::time_point::max()), mineProbability);
+
+    if (bestCell == -1)
+        return std::nullopt;
+
+    return m_Safes.Cell(bestCell);
+}
+
+std::optional<def::Vector2i> MinesweeperAI::MakeGuessMove()
+{
+    return BestMove(std::chrono::steady_clock::time_point::max()).move;
+}
+
+BestMoveResult MinesweeperAI::BestMove(std::chrono::steady_clock::time_point deadline)
+{
+    BestMoveResult result;
+
+    if (auto move = MakeSafeMove())
+    {
+        result.move = move;
+        result.completeness = AnswerCompleteness::Deduced;
+        return result;
+    }
+
+    if (m_RandomCandidates.empty())
+        return result;
+
+    // The Random strategy and a guess without time for the probabilities
+    // treat every candidate as good as the others
+    bool randomStrategy = m_GuessStrategy == GuessStrategy::Random;
+
+    if (randomStrategy || std::chrono::steady_clock::now() >= deadline)
+    {
+        int minesLeft = std::max(0, m_MinesCount - m_Mines.Count());
+
+        result.move = MakeRandomMove();
+        result.mineProbability = std::min(1.0, double(minesLeft) / m_RandomCandidates.size());
+        result.completeness = randomStrategy ? AnswerCompleteness::Random : AnswerCompleteness::Fallback;
+        return result;
+    }
+
+    MineProbabilities probabilities = ComputeProbabilities(deadline);
+
+    // Only the strategies that look at the neighbours of the cells
+    // need the probabilities of the whole board
+    std::vector<double>& mineProbabilities = m_MineProbabilities;
+
+    if (m_GuessStrategy != GuessStrategy::LowestProbability)
+    {
+        for (int cell : m_RandomCandidates)
+            mineProbabilities[cell] = probabilities.otherProbability;
+
+        for (int i = 0; i < int(probabilities.cells.size()); i++)
+            mineProbabilities[probabilities.cells[i]] = probabilities.probabilities[i];
+    }
+
+    int bestCell = -1;
+
+    switch (m_GuessStrategy)
+    {
+    case GuessStrategy::Random:
+    case GuessStrategy::LowestProbability:
+        bestCell = GuessLowest(probabilities, result.mineProbability);
+        break;
+
+    case GuessStrategy::Corners:
+    {
+        // The first move always opens an empty region, which is bigger
+        // away from the sides, so only the later guesses prefer the sides
+        bool firstMove = m_Moves.Count() == 0;
+
+        bestCell = GuessAmongSafest(mineProbabilities, 0.0, [&](const def::Vector2i& cell, const std::vector<double>&)
+            {
+                int neighboursCount = 0;
+
+                def::Vector2i offset;
+                for (offset.y = -1; offset.y <= 1; offset.y++)
+                    for (offset.x = -1; offset.x <= 1; offset.x++)
                     {
-                        if (!sentence1.cells.contains(cell))
-                            newCells.insert(cell);
+                        def::Vector2i neigh = cell + offset;
+                        neighboursCount += def::Vector2i(0, 0) <= neigh && neigh < m_BoardSize;
                     }
 
-                    // Ensure that the differene between 2 sets of cells
-                    // is not a blank set
-                    if (!newCells.empty())
+                return firstMove ? double(neighboursCount) : -double(neighboursCount);
+            });
+        break;
+    }
+
+    case GuessStrategy::InformationGain:
+        bestCell = GuessAmongSafest(mineProbabilities, INFORMATION_SAFETY_MARGIN, [&](const def::Vector2i& cell, const std::vector<double>& mineProbabilities)
+            {
+                // Distribution of the number of the cell if the neighbours
+                // were independent, known mines and safes have 1 and 0
+                double counts[9] = { 1.0 };
+                int neighboursCount = 0;
+
+                def::Vector2i offset;
+                for (offset.y = -1; offset.y <= 1; offset.y++)
+                    for (offset.x = -1; offset.x <= 1; offset.x++)
                     {
-                        Sentence newSentence(newCells, newCount);
+                        def::Vector2i neigh = cell + offset;
 
-                        // Add a new sentence to our knowledge base if it
-                        // is not already there
-                        if (!Vector_Contains(newSentences, newSentence) && !Vector_Contains(m_Knowledge, newSentence))
-                            newSentences.push_back(newSentence);
+                        if (offset == def::Vector2i(0, 0) || !(def::Vector2i(0, 0) <= neigh && neigh < m_BoardSize))
+                            continue;
+
+                        double p = mineProbabilities[m_Safes.Index(neigh)];
+                        neighboursCount++;
+
+                        for (int k = neighboursCount; k > 0; k--)
+                            counts[k] = counts[k] * (1.0 - p) + counts[k - 1] * p;
+
+                        counts[0] *= 1.0 - p;
                     }
+
+                double entropy = 0.0;
+
+                for (double count : counts)
+                {
+                    if (count > 0.0)
+                        entropy -= count * std::log2(count);
                 }
-            }
-        }
 
-    for (const auto& sentence : newSentences)
-        m_Knowledge.push_back(sentence);
+                // Only a safe cell shows its number
+                return (1.0 - mineProbabilities[m_Safes.Index(cell)]) * entropy;
+            });
+        break;
+    }
+
+    if (bestCell == -1)
+        return result;
+
+    result.move = m_Safes.Cell(bestCell);
+
+    if (m_GuessStrategy != GuessStrategy::LowestProbability)
+        result.mineProbability = mineProbabilities[bestCell];
 
-    MarkCells();
+    if (probabilities.timedOut || !(probabilities.exact || probabilities.sampled))
+        result.completeness = AnswerCompleteness::Partial;
+    else if (probabilities.sampled)
+        result.completeness = AnswerCompleteness::Sampled;
+    else
+        result.completeness = AnswerCompleteness::Exact;
+
+    return result;
 }
-    
-std::optional<def::Vector2i> MinesweeperAI::MakeSafeMove()
+
+MineProbabilities MinesweeperAI::ComputeProbabilities(std::chrono::steady_clock::time_point deadline)
 {
-    for (const auto& move : m_Safes)
-    {
-        if (!m_Moves.contains(move))
-            return move;
-    }
+    // All safe cells have been moved to at this point
+    int unknownCount = m_BoardSize.x * m_BoardSize.y - m_Safes.Count() - m_Mines.Count();
+    int minesLeft = std::max(0, m_MinesCount - m_Mines.Count());
 
-    return std::nullopt;
+    return m_Solver.Solve(m_Knowledge, unknownCount, minesLeft, deadline);
 }
 
-std::optional<def::Vector2i> MinesweeperAI::MakeRandomMove()
+int MinesweeperAI::GuessLowest(const MineProbabilities& probabilities, double& mineProbability)
 {
-    std::unordered_set<def::Vector2i> explored;
-    int availableCells = m_BoardSize.x * m_BoardSize.y - m_Mines.size() - m_Safes.size();
+    int bestCell = -1;
+    double bestProbability = 2.0;
 
-    if (availableCells == 0)
-        return std::nullopt;
+    for (int i = 0; i < int(probabilities.cells.size()); i++)
+    {
+        if (probabilities.probabilities[i] < bestProbability)
+        {
+            bestCell = probabilities.cells[i];
+            bestProbability = probabilities.probabilities[i];
+        }
+    }
 
-    srand(time(nullptr));
+    mineProbability = bestProbability;
 
-    while (true)
+    if (probabilities.otherCount > 0 && probabilities.otherProbability < bestProbability)
     {
-        def::Vector2i cell(rand() % m_BoardSize.x, rand() % m_BoardSize.y);
-        
-        if (!explored.contains(cell))
+        // Any cell outside of the frontier is as good as the others,
+        // so pick one of them at random. A few draws from the candidates
+        // usually hit one, otherwise they are counted in the list
+        mineProbability = probabilities.otherProbability;
+
+        for (int draw = 0; draw < MAX_OTHER_CELL_DRAWS; draw++)
         {
-            if (!m_Moves.contains(cell) && !m_Mines.contains(cell))
+            int cell = m_RandomCandidates[m_Random.NextInt(int(m_RandomCandidates.size()))];
+
+            if (m_CellSentences[cell].empty())
                 return cell;
+        }
+
+        int choice = m_Random.NextInt(probabilities.otherCount);
 
-            explored.insert(cell);
+        for (int cell : m_RandomCandidates)
+        {
+            if (m_CellSentences[cell].empty() && choice-- == 0)
+                return cell;
         }
     }
+
+    return bestCell;
 }
 
-void MinesweeperAI::MarkCells()
+template<typename Score>
+int MinesweeperAI::GuessAmongSafest(const std::vector<double>& mineProbabilities, double margin, Score score)
 {
-    std::unordered_set<def::Vector2i> newSafes;
-    std::unordered_set<def::Vector2i> newMines;
+    double lowest = 1.0;
+
+    for (int cell : m_RandomCandidates)
+        lowest = std::min(lowest, mineProbabilities[cell]);
+
+    // Small differences in the probabilities come from rounding
+    double limit = lowest + std::max(margin, 1e-9);
 
-    for (const auto& sentence : m_Knowledge)
+    int bestCell = -1;
+    double bestScore = 0.0;
+    int tiesCount = 0;
+
+    for (int cell : m_RandomCandidates)
     {
-        for (const auto& safe : sentence.GetKnownSafes())
-            newSafes.insert(safe);
+        if (mineProbabilities[cell] > limit)
+            continue;
+
+        double cellScore = score(m_Safes.Cell(cell), mineProbabilities);
 
-        for (const auto& mine : sentence.GetKnownMines())
-            newMines.insert(mine);
+        if (bestCell == -1 || cellScore > bestScore + 1e-9)
+        {
+            bestCell = cell;
+            bestScore = cellScore;
+            tiesCount = 1;
+        }
+
+        // Equal cells are chosen at random, like the other guesses
+        else if (cellScore >= bestScore - 1e-9 && m_Random.NextInt(++tiesCount) == 0)
+            bestCell = cell;
     }
 
-    for (const auto& safe : newSafes)
-        MarkSafe(safe);
+    return bestCell;
+}
+
+void MinesweeperAI::SetDeductionEngine(DeductionEngine engine)
+{
+    m_DeductionEngine = engine;
+}
 
-    for (const auto& mine : newMines)
-        MarkMine(mine);
+DeductionEngine MinesweeperAI::GetDeductionEngine() const
+{
+    return m_DeductionEngine;
 }
 
-const std::unordered_set<def::Vector2i>& MinesweeperAI::GetKnownMines() const
+void MinesweeperAI::SetGuessStrategy(GuessStrategy strategy)
+{
+    m_GuessStrategy = strategy;
+}
+
+GuessStrategy MinesweeperAI::GetGuessStrategy() const
+{
+    return m_GuessStrategy;
+}
+
+void MinesweeperAI::SetSamplingBudget(std::chrono::microseconds budget)
+{
+    m_Solver.SetSamplingBudget(budget);
+}
+
+std::chrono::microseconds MinesweeperAI::GetSamplingBudget() const
+{
+    return m_Solver.GetSamplingBudget();
+}
+
+const BitBoard& MinesweeperAI::GetKnownMines() const
 {
     return m_Mines;
 }
+
+const BitBoard& MinesweeperAI::GetKnownSafes() const
+{
+    return m_Safes;
+}
+
+const InferenceStats& MinesweeperAI::GetLastInferenceStats() const
+{
+    return m_LastInference;
+}
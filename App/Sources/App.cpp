@@ -1,5 +1,36 @@
 ﻿#include "../Include/App.hpp"
 
+namespace
+{
+    const char* GetStrategyName(GuessStrategy strategy)
+    {
+        switch (strategy)
+        {
+        case GuessStrategy::Random: return "Random";
+        case GuessStrategy::LowestProbability: return "Lowest risk";
+        case GuessStrategy::Corners: return "Corners";
+        case GuessStrategy::InformationGain: return "Information";
+        }
+
+        return "";
+    }
+
+    const char* GetCompletenessName(AnswerCompleteness completeness)
+    {
+        switch (completeness)
+        {
+        case AnswerCompleteness::Fallback: return "random, out of time";
+        case AnswerCompleteness::Random: return "random";
+        case AnswerCompleteness::Partial: return "rough, out of time";
+        case AnswerCompleteness::Sampled: return "sampled";
+        case AnswerCompleteness::Exact: return "exact";
+        case AnswerCompleteness::Deduced: return "deduced";
+        }
+
+        return "";
+    }
+}
+
 bool Rect2i::Contains(const def::Vector2i& p)
 {
     return pos <= p && p < pos + size;
@@ -12,7 +43,7 @@ App::App()
 
 App::~App()
 {
-
+    m_Writer.EndGame(GameResult::Unfinished);
 }
 
 bool App::OnUserCreate()
@@ -32,8 +63,9 @@ bool App::OnUserCreate()
     m_MineImage.Load("../../App/Assets/mine.png");
 
     // Construct the game class and the AI
-    m_Game = std::make_unique<Minesweeper>(config::BOARD_SIZE, config::MINES_COUNT);
-    m_AI = std::make_unique<MinesweeperAI>(config::BOARD_SIZE);
+    NewGame();
+
+    m_Record.open(config::RECORD_PATH, std::ios::binary | std::ios::app);
 
     return true;
 }
@@ -110,6 +142,21 @@ bool App::OnUserUpdate(float deltaTime)
         aiButtonRect.size
     };
 
+    // Switch to the next guess strategy, the log of a game that has
+    // already begun keeps its strategy so the game is started with a new one
+    if (inp->GetKeyState(def::Key::G).released)
+    {
+        m_GuessStrategy = GuessStrategy((int(m_GuessStrategy) + 1) % (int(GuessStrategy::InformationGain) + 1));
+
+        if (m_FirstMove)
+        {
+            m_AI->SetGuessStrategy(m_GuessStrategy);
+            std::cout << "AI guesses with the strategy: " << GetStrategyName(m_GuessStrategy) << std::endl;
+        }
+        else
+            std::cout << "AI will guess with the strategy " << GetStrategyName(m_GuessStrategy) << " from the next game" << std::endl;
+    }
+
     // Place a flag on the board on the right mouse button click
     if (inp->GetButtonState(def::Button::RIGHT).released)
     {
@@ -120,13 +167,20 @@ bool App::OnUserUpdate(float deltaTime)
             // Calculating the position of the cell on the board
             def::Vector2i cellCoord = (mousePos - config::BOARD_ORIGIN) / m_CellSize;
             
-            // Place the flag if it was not here and vice versa
-            auto cell = m_Game->GetCell(cellCoord);
-            cell.isFlagged = !cell.isFlagged;
+            // Place the flag if it was not here and vice versa,
+            // open cells can't be flagged so nothing is logged for them
+            bool wasFlagged = m_Game->GetCell(cellCoord).isFlagged;
+            m_Game->ToggleFlag(cellCoord);
+
+            bool isFlagged = m_Game->GetCell(cellCoord).isFlagged;
+
+            if (isFlagged != wasFlagged)
+                m_Writer.AddMove(isFlagged ? MoveKind::SetFlag : MoveKind::ClearFlag, cellCoord);
         }
     }
 
     std::optional<def::Vector2i> move = std::nullopt;
+    MoveKind moveKind = MoveKind::Open;
 
     if (inp->GetButtonState(def::Button::LEFT).released)
     {
@@ -135,30 +189,43 @@ bool App::OnUserUpdate(float deltaTime)
         // Make a move if the player hasn't lost the game
         if (aiButtonRect.Contains(mousePos) && !m_Lost)
         {
-            // Trying to make a safe move
-            if (move = m_AI->MakeSafeMove())
+            // Trying to make a safe move and making a guess
+            // with the chosen strategy otherwise
+            BestMoveResult answer = m_AI->BestMove(std::chrono::steady_clock::now() + config::AI_MOVE_BUDGET);
+            move = answer.move;
+
+            if (!move)
+                std::cout << "No moves left to make" << std::endl;
+            else if (answer.completeness == AnswerCompleteness::Deduced)
+            {
                 std::cout << "AI makes a safe move: " << move->ToString() << std::endl;
-
-            // Making a random move
+                moveKind = MoveKind::SafeMove;
+            }
             else
             {
-                if (move = m_AI->MakeRandomMove())
-                    std::cout << "No known safe moves, making random move: " << move->ToString() << std::endl;
-                else
-                    std::cout << "No moves left to make" << std::endl;
+                std::cout << "No known safe moves, making a guess: " << move->ToString()
+                    << " (" << GetCompletenessName(answer.completeness) << ", mine chance "
+                    << int(answer.mineProbability * 100.0 + 0.5) << "%)" << std::endl;
+
+                moveKind = MoveKind::GuessMove;
             }
 
             // Updating flags in the game based on the AI knowledge
             for (const auto& mine : m_AI->GetKnownMines())
-                m_Game->GetCell(mine).isFlagged = true;
+            {
+                if (!m_Game->GetCell(mine).isFlagged)
+                {
+                    m_Game->SetFlag(mine, true);
+                    m_Writer.AddMove(MoveKind::SetFlag, mine);
+                }
+            }
         }
 
         // Reset the game state
         else if (resetButtonRect.Contains(mousePos))
         {
-            m_Game.reset(new Minesweeper(config::BOARD_SIZE, config::MINES_COUNT));
-            m_AI.reset(new MinesweeperAI(config::BOARD_SIZE));
-            m_Lost = false;
+            m_Writer.EndGame(GameResult::Unfinished);
+            NewGame();
         }
 
         // Open a cell on the left mouse button click
@@ -182,19 +249,34 @@ bool App::OnUserUpdate(float deltaTime)
     if (move)
     {
         def::Vector2i cellCoord = move.value();
-        auto& cell = m_Game->GetCell(cellCoord);
 
-        if (cell.isMine)
+        if (m_FirstMove)
+        {
+            m_Game->PlaceMines(cellCoord);
+            m_FirstMove = false;
+
+            m_Writer.BeginGame(*m_Game, m_BoardSeed, m_AISeed, m_AI->GetDeductionEngine(), m_AI->GetGuessStrategy());
+        }
+
+        m_Writer.AddMove(moveKind, cellCoord);
+
+        if (m_Game->GetCell(cellCoord).isMine)
+        {
             m_Lost = true;
+            m_Writer.EndGame(GameResult::Lost);
+        }
         else
         {
-            cell.isRevealed = true;
-            m_AI->AddKnowledge(cellCoord, cell.nearbyMinesCount);
+            // Opens the whole empty region around the cell at once
+            m_AI->AddKnowledgeBatch(m_Game->Reveal(cellCoord));
         }
     }
 
     bool won = !m_Lost && m_Game->Won();
 
+    if (won)
+        m_Writer.EndGame(GameResult::Won);
+
     Clear(def::BLACK);
 
     // Draw the board
@@ -227,6 +309,17 @@ bool App::OnUserUpdate(float deltaTime)
     DrawButton(aiButtonRect, "AI Move");
     DrawButton(resetButtonRect, "Reset");
 
+    DrawCenteredText(
+        resetButtonRect.pos + def::Vector2i(resetButtonRect.size.x / 2, resetButtonRect.size.y + 30),
+        std::string("Guess: ") + GetStrategyName(m_AI->GetGuessStrategy()), def::WHITE);
+
+    if (m_AI->GetGuessStrategy() != m_GuessStrategy)
+    {
+        DrawCenteredText(
+            resetButtonRect.pos + def::Vector2i(resetButtonRect.size.x / 2, resetButtonRect.size.y + 50),
+            std::string("Next game: ") + GetStrategyName(m_GuessStrategy), def::GREY);
+    }
+
     if (m_Lost || won)
     {
         std::string text;
@@ -271,3 +364,19 @@ void App::DrawWithinCell(const def::Vector2i& pos, const def::Graphic& gfx)
 {
     DrawTexture(pos, gfx.texture, m_CellSize / def::Vector2f(gfx.texture->size));
 }
+
+void App::NewGame()
+{
+    // The seeds are kept for the log of the game
+    Random random;
+
+    m_BoardSeed = random.Next();
+    m_AISeed = random.Next();
+
+    m_Game = std::make_unique<Minesweeper>(config::BOARD_SIZE, config::MINES_COUNT, Random(m_BoardSeed));
+    m_AI = std::make_unique<MinesweeperAI>(config::BOARD_SIZE, config::MINES_COUNT, Random(m_AISeed));
+    m_AI->SetGuessStrategy(m_GuessStrategy);
+
+    m_Lost = false;
+    m_FirstMove = true;
+}
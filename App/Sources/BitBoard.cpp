@@ -0,0 +1,250 @@
+#include "../Include/BitBoard.hpp"
+
+BitBoard::Iterator::Iterator(const BitBoard* board, int word)
+    : m_Board(board), m_Word(word), m_Bits(0)
+{
+    SkipEmptyWords();
+}
+
+def::Vector2i BitBoard::Iterator::operator*() const
+{
+    return m_Board->Cell(m_Word * WORD_BITS + std::countr_zero(m_Bits));
+}
+
+BitBoard::Iterator& BitBoard::Iterator::operator++()
+{
+    // Clear the lowest bit and move to the next word if
+    // there are no cells left in the current one
+    m_Bits &= m_Bits - 1;
+
+    if (m_Bits == 0)
+    {
+        m_Word++;
+        SkipEmptyWords();
+    }
+
+    return *this;
+}
+
+bool BitBoard::Iterator::operator!=(const Iterator& other) const
+{
+    return m_Word != other.m_Word || m_Bits != other.m_Bits;
+}
+
+void BitBoard::Iterator::SkipEmptyWords()
+{
+    int wordsCount = m_Board->m_Words.size();
+
+    while (m_Word < wordsCount)
+    {
+        m_Bits = m_Board->m_Words[m_Word];
+
+        if (m_Bits != 0)
+            return;
+
+        m_Word++;
+    }
+
+    m_Bits = 0;
+}
+
+BitBoard::BitBoard(const def::Vector2i& boardSize)
+    : m_BoardSize(boardSize)
+{
+    int cellsCount = boardSize.x * boardSize.y;
+    m_Words.resize((cellsCount + WORD_BITS - 1) / WORD_BITS);
+}
+
+int BitBoard::Index(const def::Vector2i& cell) const
+{
+    return cell.y * m_BoardSize.x + cell.x;
+}
+
+def::Vector2i BitBoard::Cell(int index) const
+{
+    return { index % m_BoardSize.x, index / m_BoardSize.x };
+}
+
+bool BitBoard::Contains(int index) const
+{
+    return (m_Words[index / WORD_BITS] >> (index % WORD_BITS)) & 1;
+}
+
+bool BitBoard::Contains(const def::Vector2i& cell) const
+{
+    return Contains(Index(cell));
+}
+
+void BitBoard::Insert(int index)
+{
+    m_Words[index / WORD_BITS] |= Word(1) << (index % WORD_BITS);
+}
+
+void BitBoard::Insert(const def::Vector2i& cell)
+{
+    Insert(Index(cell));
+}
+
+void BitBoard::Erase(int index)
+{
+    m_Words[index / WORD_BITS] &= ~(Word(1) << (index % WORD_BITS));
+}
+
+void BitBoard::Erase(const def::Vector2i& cell)
+{
+    Erase(Index(cell));
+}
+
+int BitBoard::Count() const
+{
+    int count = 0;
+
+    for (Word word : m_Words)
+        count += std::popcount(word);
+
+    return count;
+}
+
+BitBoard::Iterator BitBoard::begin() const
+{
+    return Iterator(this, 0);
+}
+
+BitBoard::Iterator BitBoard::end() const
+{
+    return Iterator(this, m_Words.size());
+}
+
+bool CellSet::Contains(int index) const
+{
+    int word = index / BitBoard::WORD_BITS;
+
+    for (const auto& chunk : m_Chunks)
+    {
+        if (chunk.word == word)
+            return (chunk.bits >> (index % BitBoard::WORD_BITS)) & 1;
+    }
+
+    return false;
+}
+
+void CellSet::Insert(int index)
+{
+    int word = index / BitBoard::WORD_BITS;
+    BitBoard::Word bit = BitBoard::Word(1) << (index % BitBoard::WORD_BITS);
+
+    // Keep the chunks sorted so equal sets are stored equally
+    auto it = std::ranges::lower_bound(m_Chunks, word, {}, &Chunk::word);
+
+    if (it != m_Chunks.end() && it->word == word)
+        it->bits |= bit;
+    else
+        m_Chunks.insert(it, { word, bit });
+}
+
+bool CellSet::Erase(int index)
+{
+    int word = index / BitBoard::WORD_BITS;
+    BitBoard::Word bit = BitBoard::Word(1) << (index % BitBoard::WORD_BITS);
+
+    for (auto it = m_Chunks.begin(); it != m_Chunks.end(); it++)
+    {
+        if (it->word == word)
+        {
+            if ((it->bits & bit) == 0)
+                return false;
+
+            it->bits &= ~bit;
+
+            // Empty chunks are never stored
+            if (it->bits == 0)
+                m_Chunks.erase(it);
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int CellSet::Size() const
+{
+    int size = 0;
+
+    for (const auto& chunk : m_Chunks)
+        size += std::popcount(chunk.bits);
+
+    return size;
+}
+
+bool CellSet::Empty() const
+{
+    return m_Chunks.empty();
+}
+
+int CellSet::First() const
+{
+    const auto& chunk = m_Chunks.front();
+    return chunk.word * BitBoard::WORD_BITS + std::countr_zero(chunk.bits);
+}
+
+bool CellSet::IsSubsetOf(const CellSet& other) const
+{
+    // Both sets are sorted so we can walk them together
+    // and check that no bit is left after masking by the other set
+    auto it = other.m_Chunks.begin();
+
+    for (const auto& chunk : m_Chunks)
+    {
+        while (it != other.m_Chunks.end() && it->word < chunk.word)
+            it++;
+
+        if (it == other.m_Chunks.end() || it->word != chunk.word)
+            return false;
+
+        if ((chunk.bits & ~it->bits) != 0)
+            return false;
+    }
+
+    return true;
+}
+
+size_t CellSet::Hash() const
+{
+    uint64_t hash = 0x9E3779B97F4A7C15ULL;
+
+    for (const auto& chunk : m_Chunks)
+    {
+        // Mix each word in with the finalizer of splitmix64
+        uint64_t h = hash ^ (chunk.bits + uint64_t(chunk.word) * 0xBF58476D1CE4E5B9ULL);
+        h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+        hash = h ^ (h >> 31);
+    }
+
+    return hash;
+}
+
+CellSet CellSet::Difference(const CellSet& other) const
+{
+    CellSet result;
+    result.m_Chunks.reserve(m_Chunks.size());
+
+    auto it = other.m_Chunks.begin();
+
+    for (const auto& chunk : m_Chunks)
+    {
+        while (it != other.m_Chunks.end() && it->word < chunk.word)
+            it++;
+
+        BitBoard::Word bits = chunk.bits;
+
+        if (it != other.m_Chunks.end() && it->word == chunk.word)
+            bits &= ~it->bits;
+
+        if (bits != 0)
+            result.m_Chunks.push_back({ chunk.word, bits });
+    }
+
+    return result;
+}
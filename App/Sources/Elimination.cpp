@@ -0,0 +1,205 @@
+#include "../Include/Elimination.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <numeric>
+
+namespace
+{
+    // Rows with bigger numbers are dropped so the products never overflow
+    constexpr int64_t MAX_COEFFICIENT = int64_t(1) << 30;
+
+    constexpr int WORD_BITS = 64;
+
+    bool TestBit(const std::vector<uint64_t>& bits, int i)
+    {
+        return (bits[i / WORD_BITS] >> (i % WORD_BITS)) & 1;
+    }
+}
+
+ForcedCells EliminationSolver::Solve(const std::vector<FrontierComponent>& components)
+{
+    ForcedCells forced;
+
+    for (const auto& component : components)
+    {
+        int columnsCount = component.cells.size();
+        int wordsCount = (columnsCount + WORD_BITS - 1) / WORD_BITS;
+
+        std::vector<Row> rows;
+        rows.reserve(component.constraints.size());
+
+        for (const auto& constraint : component.constraints)
+        {
+            Row row;
+            row.support.resize(wordsCount);
+            row.coefficients.resize(columnsCount);
+            row.value = constraint.minesCount;
+
+            for (int var : constraint.vars)
+            {
+                row.support[var / WORD_BITS] |= uint64_t(1) << (var % WORD_BITS);
+                row.coefficients[var] = 1;
+            }
+
+            rows.push_back(std::move(row));
+        }
+
+        Reduce(rows, columnsCount);
+        Deduce(component, rows, forced);
+    }
+
+    return forced;
+}
+
+void EliminationSolver::Reduce(std::vector<Row>& rows, int columnsCount)
+{
+    int pivotRow = 0;
+
+    for (int column = 0; column < columnsCount && pivotRow < int(rows.size()); column++)
+    {
+        int found = -1;
+
+        for (int r = pivotRow; r < int(rows.size()); r++)
+        {
+            if (TestBit(rows[r].support, column))
+            {
+                found = r;
+                break;
+            }
+        }
+
+        if (found == -1)
+            continue;
+
+        std::swap(rows[found], rows[pivotRow]);
+
+        const Row& pivot = rows[pivotRow];
+
+        // Clear the column in all other rows (Gauss-Jordan),
+        // so every pivot column appears in a single row only
+        for (int r = 0; r < int(rows.size()); r++)
+        {
+            if (r != pivotRow && TestBit(rows[r].support, column))
+                Combine(rows[r], pivot, pivot.coefficients[column], rows[r].coefficients[column]);
+        }
+
+        pivotRow++;
+    }
+}
+
+void EliminationSolver::Combine(Row& rowA, const Row& rowB, int64_t a, int64_t b)
+{
+    auto tooBig = [](const Row& row)
+        {
+            if (std::abs(row.value) >= MAX_COEFFICIENT)
+                return true;
+
+            for (int64_t coefficient : row.coefficients)
+            {
+                if (std::abs(coefficient) >= MAX_COEFFICIENT)
+                    return true;
+            }
+
+            return false;
+        };
+
+    if (tooBig(rowA) || tooBig(rowB))
+    {
+        // Forgetting an equation loses some deductions
+        // but never gives a wrong one
+        std::ranges::fill(rowA.support, 0);
+        std::ranges::fill(rowA.coefficients, 0);
+        rowA.value = 0;
+        return;
+    }
+
+    int64_t divisor = 0;
+
+    // Only the columns that are set in one of the rows can change
+    for (int w = 0; w < int(rowA.support.size()); w++)
+    {
+        uint64_t bits = rowA.support[w] | rowB.support[w];
+        uint64_t support = 0;
+
+        for (; bits != 0; bits &= bits - 1)
+        {
+            int bit = std::countr_zero(bits);
+            int column = w * WORD_BITS + bit;
+
+            int64_t& coefficient = rowA.coefficients[column];
+            coefficient = a * coefficient - b * rowB.coefficients[column];
+
+            if (coefficient != 0)
+            {
+                support |= uint64_t(1) << bit;
+                divisor = std::gcd(divisor, coefficient);
+            }
+        }
+
+        rowA.support[w] = support;
+    }
+
+    rowA.value = a * rowA.value - b * rowB.value;
+    divisor = std::gcd(divisor, rowA.value);
+
+    if (divisor > 1)
+    {
+        for (int w = 0; w < int(rowA.support.size()); w++)
+        {
+            for (uint64_t bits = rowA.support[w]; bits != 0; bits &= bits - 1)
+                rowA.coefficients[w * WORD_BITS + std::countr_zero(bits)] /= divisor;
+        }
+
+        rowA.value /= divisor;
+    }
+}
+
+void EliminationSolver::Deduce(const FrontierComponent& component, const std::vector<Row>& rows, ForcedCells& forced)
+{
+    for (const auto& row : rows)
+    {
+        // The smallest and the biggest possible sums of the row
+        int64_t minSum = 0, maxSum = 0;
+
+        for (int w = 0; w < int(row.support.size()); w++)
+        {
+            for (uint64_t bits = row.support[w]; bits != 0; bits &= bits - 1)
+            {
+                int64_t coefficient = row.coefficients[w * WORD_BITS + std::countr_zero(bits)];
+
+                if (coefficient > 0)
+                    maxSum += coefficient;
+                else
+                    minSum += coefficient;
+            }
+        }
+
+        if (row.value < minSum || row.value > maxSum || minSum == maxSum)
+            continue;
+
+        for (int w = 0; w < int(row.support.size()); w++)
+        {
+            for (uint64_t bits = row.support[w]; bits != 0; bits &= bits - 1)
+            {
+                int var = w * WORD_BITS + std::countr_zero(bits);
+                int64_t coefficient = row.coefficients[var];
+
+                // Range of the sum if the cell is a mine and if it's not
+                int64_t minIfMine = minSum + std::max<int64_t>(coefficient, 0);
+                int64_t maxIfMine = maxSum + std::min<int64_t>(coefficient, 0);
+                int64_t minIfSafe = minSum - std::min<int64_t>(coefficient, 0);
+                int64_t maxIfSafe = maxSum - std::max<int64_t>(coefficient, 0);
+
+                bool canBeMine = minIfMine <= row.value && row.value <= maxIfMine;
+                bool canBeSafe = minIfSafe <= row.value && row.value <= maxIfSafe;
+
+                if (canBeMine && !canBeSafe)
+                    forced.mines.push_back(component.cells[var]);
+                else if (canBeSafe && !canBeMine)
+                    forced.safes.push_back(component.cells[var]);
+            }
+        }
+    }
+}
@@ -0,0 +1,673 @@
+#include "../Include/Frontier.hpp"
+#include "../Include/AI.hpp"
+#include "../Include/Sampler.hpp"
+#include "../Include/ThreadPool.hpp"
+
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace
+{
+    constexpr size_t MAX_CACHE_SIZE = 4096;
+
+    // The clock is read only once per that many steps of the enumeration
+    constexpr int64_t DEADLINE_CHECK_STEPS = 1 << 12;
+
+    /*
+    Backtracking over the cells of a component. The cells are assigned
+    in the order in which they are reached through the constraints,
+    so a constraint is usually complete soon after its first cell
+    is assigned and a wrong branch is cut off early.
+
+    The values of some cells can be fixed beforehand,
+    then only the layouts with these values are enumerated.
+    */
+    class Enumerator
+    {
+    public:
+        Enumerator(const FrontierComponent& component, int maxMines, ComponentLayouts& result,
+            const std::vector<std::pair<int, int>>& fixed, int64_t maxSteps, std::chrono::steady_clock::time_point deadline)
+            : m_Component(component), m_MaxMines(maxMines), m_Result(result), m_MaxSteps(maxSteps), m_Deadline(deadline)
+        {
+            int varsCount = component.cells.size();
+
+            m_VarConstraints.resize(varsCount);
+            m_Mines.resize(component.constraints.size());
+            m_Unassigned.resize(component.constraints.size());
+            m_Values.resize(varsCount);
+            m_Fixed.resize(varsCount, -1);
+
+            for (int c = 0; c < int(component.constraints.size()); c++)
+            {
+                const auto& constraint = component.constraints[c];
+                m_Unassigned[c] = constraint.vars.size();
+
+                for (int var : constraint.vars)
+                    m_VarConstraints[var].push_back(c);
+            }
+
+            // Order the cells with a breadth first search over the constraints
+            // starting from the fixed cells
+            std::vector<bool> visited(varsCount);
+
+            for (const auto& [var, value] : fixed)
+            {
+                visited[var] = true;
+                m_Order.push_back(var);
+                m_Fixed[var] = value;
+            }
+
+            for (int start = -1; start < varsCount; start++)
+            {
+                if (start >= 0)
+                {
+                    if (visited[start])
+                        continue;
+
+                    visited[start] = true;
+                    m_Order.push_back(start);
+                }
+
+                for (int i = (start >= 0) ? int(m_Order.size()) - 1 : 0; i < int(m_Order.size()); i++)
+                {
+                    for (int c : m_VarConstraints[m_Order[i]])
+                    {
+                        for (int var : component.constraints[c].vars)
+                        {
+                            if (!visited[var])
+                            {
+                                visited[var] = true;
+                                m_Order.push_back(var);
+                            }
+                        }
+                    }
+                }
+            }
+
+            m_Result.layouts.assign(maxMines + 1, 0.0);
+            m_Result.mines.assign(maxMines + 1, std::vector<double>(varsCount, 0.0));
+            m_Result.complete = true;
+            m_Result.timedOut = false;
+        }
+
+        void Run()
+        {
+            Visit(0, 0);
+        }
+
+    private:
+        void Visit(int depth, int mines)
+        {
+            if (++m_Steps > m_MaxSteps)
+            {
+                m_Result.complete = false;
+                return;
+            }
+
+            if (m_Steps % DEADLINE_CHECK_STEPS == 0 && std::chrono::steady_clock::now() >= m_Deadline)
+            {
+                m_Result.complete = false;
+                m_Result.timedOut = true;
+                return;
+            }
+
+            if (depth == int(m_Order.size()))
+            {
+                Record(mines);
+                return;
+            }
+
+            int var = m_Order[depth];
+
+            for (int value = 0; value <= 1; value++)
+            {
+                if (mines + value > m_MaxMines)
+                    break;
+
+                if (m_Fixed[var] != -1 && m_Fixed[var] != value)
+                    continue;
+
+                if (Assign(var, value))
+                {
+                    m_Values[var] = value;
+                    Visit(depth + 1, mines + value);
+                }
+
+                Unassign(var, value);
+
+                if (!m_Result.complete)
+                    return;
+            }
+        }
+
+        // Returns false if some constraint can't be satisfied anymore
+        bool Assign(int var, int value)
+        {
+            bool feasible = true;
+
+            for (int c : m_VarConstraints[var])
+            {
+                m_Unassigned[c]--;
+                m_Mines[c] += value;
+
+                int minesCount = m_Component.constraints[c].minesCount;
+
+                if (m_Mines[c] > minesCount || m_Mines[c] + m_Unassigned[c] < minesCount)
+                    feasible = false;
+            }
+
+            return feasible;
+        }
+
+        void Unassign(int var, int value)
+        {
+            for (int c : m_VarConstraints[var])
+            {
+                m_Unassigned[c]++;
+                m_Mines[c] -= value;
+            }
+        }
+
+        void Record(int mines)
+        {
+            m_Result.layouts[mines] += 1.0;
+
+            auto& cellMines = m_Result.mines[mines];
+
+            for (int var = 0; var < int(m_Values.size()); var++)
+                cellMines[var] += m_Values[var];
+        }
+
+    private:
+        const FrontierComponent& m_Component;
+        int m_MaxMines;
+
+        ComponentLayouts& m_Result;
+
+        std::vector<std::vector<int>> m_VarConstraints;
+        std::vector<int> m_Order;
+
+        // Mines and unassigned cells left in each constraint
+        std::vector<int> m_Mines;
+        std::vector<int> m_Unassigned;
+
+        std::vector<int> m_Values;
+        std::vector<int> m_Fixed;
+
+        int64_t m_Steps = 0;
+        int64_t m_MaxSteps;
+
+        std::chrono::steady_clock::time_point m_Deadline;
+
+    };
+
+    // Returns the first 'size' terms of the product of two polynomials
+    std::vector<double> Convolve(const std::vector<double>& a, const std::vector<double>& b, int size)
+    {
+        std::vector<double> result(std::min<int>(size, a.size() + b.size() - 1), 0.0);
+
+        for (int i = 0; i < int(a.size()) && i < int(result.size()); i++)
+        {
+            if (a[i] == 0.0)
+                continue;
+
+            for (int j = 0; j < int(b.size()) && i + j < int(result.size()); j++)
+                result[i + j] += a[i] * b[j];
+        }
+
+        // Only the ratios matter so keep the numbers in a sane range
+        double max = *std::max_element(result.begin(), result.end());
+
+        if (max > 0.0)
+        {
+            for (auto& v : result)
+                v /= max;
+        }
+
+        return result;
+    }
+}
+
+FrontierSolver::FrontierSolver(int cellsCount)
+    : m_Variables(cellsCount, -1), m_LogFactorials(cellsCount + 1)
+{
+    // std::lgamma is not used since it writes to a global variable
+    // and the solvers of different games can run on different threads
+    for (int i = 1; i <= cellsCount; i++)
+        m_LogFactorials[i] = m_LogFactorials[i - 1] + std::log(double(i));
+}
+
+size_t FrontierSolver::KeyHash::operator()(const std::vector<int>& key) const
+{
+    size_t hash = key.size();
+
+    for (int v : key)
+        hash ^= size_t(v) + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2);
+
+    return hash;
+}
+
+std::vector<FrontierComponent> FrontierSolver::SplitFrontier(const std::vector<Sentence>& knowledge)
+{
+    std::vector<int> cells;
+    std::vector<int> parents;
+
+    auto find = [&](int var)
+        {
+            while (parents[var] != var)
+            {
+                parents[var] = parents[parents[var]];
+                var = parents[var];
+            }
+
+            return var;
+        };
+
+    // Give every frontier cell a variable and join
+    // the variables of each sentence together
+    for (const auto& sentence : knowledge)
+    {
+        if (sentence.minesCount < 0)
+            continue;
+
+        int first = -1;
+
+        sentence.cells.ForEach([&](int cell)
+            {
+                int& var = m_Variables[cell];
+
+                if (var == -1)
+                {
+                    var = cells.size();
+                    cells.push_back(cell);
+                    parents.push_back(var);
+                }
+
+                if (first == -1)
+                    first = var;
+                else
+                    parents[find(var)] = find(first);
+            });
+    }
+
+    std::vector<FrontierComponent> components;
+    std::vector<int> componentOf(cells.size(), -1);
+
+    // Number the cells of each component in the order of their board indices,
+    // so components of the same shape get the same cache key
+    std::vector<int> order(cells.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::sort(order, {}, [&](int var) { return cells[var]; });
+
+    std::vector<int> localVar(cells.size());
+
+    for (int var : order)
+    {
+        int root = find(var);
+
+        if (componentOf[root] == -1)
+        {
+            componentOf[root] = components.size();
+            components.emplace_back();
+        }
+
+        auto& component = components[componentOf[root]];
+
+        localVar[var] = component.cells.size();
+        component.cells.push_back(cells[var]);
+    }
+
+    for (const auto& sentence : knowledge)
+    {
+        if (sentence.minesCount < 0 || sentence.cells.Empty())
+            continue;
+
+        FrontierComponent::Constraint constraint;
+        constraint.minesCount = sentence.minesCount;
+
+        sentence.cells.ForEach([&](int cell) { constraint.vars.push_back(localVar[m_Variables[cell]]); });
+        std::ranges::sort(constraint.vars);
+
+        int root = find(m_Variables[sentence.cells.First()]);
+        components[componentOf[root]].constraints.push_back(std::move(constraint));
+    }
+
+    for (auto& component : components)
+    {
+        std::ranges::sort(component.constraints, {}, &FrontierComponent::Constraint::vars);
+    }
+
+    // Leave the lookup table clean for the next call
+    for (int cell : cells)
+        m_Variables[cell] = -1;
+
+    return components;
+}
+
+std::vector<int> FrontierSolver::MakeKey(const FrontierComponent& component, int maxMines)
+{
+    std::vector<int> key;
+    key.push_back(maxMines);
+    key.push_back(component.cells.size());
+
+    for (const auto& constraint : component.constraints)
+    {
+        key.push_back(constraint.minesCount);
+        key.push_back(constraint.vars.size());
+        key.insert(key.end(), constraint.vars.begin(), constraint.vars.end());
+    }
+
+    return key;
+}
+
+std::vector<const ComponentLayouts*> FrontierSolver::Enumerate(const std::vector<FrontierComponent>& components, int maxMines,
+    std::chrono::steady_clock::time_point deadline)
+{
+    struct Job
+    {
+        const FrontierComponent* component;
+        int maxMines;
+
+        std::vector<int> key;
+
+        // Same shapes give the same samples
+        size_t seed;
+
+        // Cells whose values are fixed to split the job into pieces
+        std::vector<int> pivots;
+        std::vector<ComponentLayouts> pieces;
+
+        ComponentLayouts* result = nullptr;
+    };
+
+    std::vector<const ComponentLayouts*> result(components.size());
+
+    std::vector<Job> jobs;
+    std::vector<int> jobOf(components.size(), -1);
+
+    std::unordered_map<std::vector<int>, int, KeyHash> scheduled;
+
+    ThreadPool& pool = ThreadPool::Shared();
+    int workersCount = pool.GetThreadsCount() + 1;
+
+    for (int i = 0; i < int(components.size()); i++)
+    {
+        const auto& component = components[i];
+        int componentMaxMines = std::min<int>(maxMines, component.cells.size());
+
+        std::vector<int> key = MakeKey(component, componentMaxMines);
+
+        auto cached = m_Cache.find(key);
+
+        // Results that were cut off by a deadline or by the sampling budget are computed again
+        if (cached != m_Cache.end() && !cached->second.timedOut && !cached->second.cutShort)
+        {
+            result[i] = &cached->second;
+            continue;
+        }
+
+        // Components of the same shape are enumerated only once
+        auto [it, inserted] = scheduled.try_emplace(key, jobs.size());
+        jobOf[i] = it->second;
+
+        if (!inserted)
+            continue;
+
+        Job job;
+        job.component = &component;
+        job.maxMines = componentMaxMines;
+        job.seed = KeyHash()(key);
+        job.key = std::move(key);
+
+        if (component.cells.size() >= SPLIT_MIN_CELLS)
+        {
+            // Fix the cells that appear in the most constraints,
+            // so each piece is cut off as early as possible
+            std::vector<int> degrees(component.cells.size());
+
+            for (const auto& constraint : component.constraints)
+            {
+                for (int var : constraint.vars)
+                    degrees[var]++;
+            }
+
+            std::vector<int> vars(component.cells.size());
+            std::iota(vars.begin(), vars.end(), 0);
+            std::ranges::stable_sort(vars, std::greater{}, [&](int var) { return degrees[var]; });
+
+            while (job.pivots.size() < MAX_SPLIT_DEPTH && (1 << job.pivots.size()) < workersCount * 4)
+                job.pivots.push_back(vars[job.pivots.size()]);
+        }
+
+        job.pieces.resize(1 << job.pivots.size());
+        jobs.push_back(std::move(job));
+    }
+
+    // Big jobs go to the pool and the small ones are done here
+    // while the workers are busy with the big ones
+    TaskGroup group;
+
+    auto run = [deadline](const Job& job, int piece, ComponentLayouts& layouts)
+        {
+            std::vector<std::pair<int, int>> fixed;
+
+            for (int p = 0; p < int(job.pivots.size()); p++)
+                fixed.emplace_back(job.pivots[p], (piece >> p) & 1);
+
+            Enumerator enumerator(*job.component, job.maxMines, layouts, fixed, MAX_ENUMERATION_STEPS / job.pieces.size(), deadline);
+            enumerator.Run();
+        };
+
+    for (auto& job : jobs)
+    {
+        if (job.component->cells.size() < PARALLEL_MIN_CELLS)
+            continue;
+
+        for (int piece = 0; piece < int(job.pieces.size()); piece++)
+            pool.Submit(group, [&run, &job, piece]() { run(job, piece, job.pieces[piece]); });
+    }
+
+    for (auto& job : jobs)
+    {
+        if (job.component->cells.size() < PARALLEL_MIN_CELLS)
+            run(job, 0, job.pieces[0]);
+    }
+
+    pool.Wait(group);
+
+    // Sum up the pieces and remember the results
+    for (auto& job : jobs)
+    {
+        ComponentLayouts& layouts = m_Cache[std::move(job.key)];
+        layouts = std::move(job.pieces[0]);
+
+        for (int piece = 1; piece < int(job.pieces.size()); piece++)
+        {
+            const auto& other = job.pieces[piece];
+
+            for (int k = 0; k < int(layouts.layouts.size()); k++)
+            {
+                layouts.layouts[k] += other.layouts[k];
+
+                for (int var = 0; var < int(layouts.mines[k].size()); var++)
+                    layouts.mines[k][var] += other.mines[k][var];
+            }
+
+            layouts.complete = layouts.complete && other.complete;
+            layouts.timedOut = layouts.timedOut || other.timedOut;
+        }
+
+        job.result = &layouts;
+    }
+
+    // Estimate the components that were too big to enumerate, all of them
+    // share the budget and the estimates replace the cut off results
+    auto samplingDeadline = std::min(deadline, std::chrono::steady_clock::now() + m_SamplingBudget);
+
+    for (auto& job : jobs)
+    {
+        if (job.result->complete)
+            continue;
+
+        pool.Submit(group, [&job, samplingDeadline, deadline]()
+            {
+                LayoutSampler sampler(*job.component, job.maxMines, job.seed);
+                sampler.Run(samplingDeadline, MAX_SAMPLES);
+
+                *job.result = sampler.GetLayouts();
+
+                // Running out of the sampling budget is expected,
+                // only the deadline of the caller makes the result worse than usual
+                bool cutShort = sampler.GetSamplesCount() < MAX_SAMPLES;
+
+                job.result->cutShort = cutShort;
+                job.result->timedOut = cutShort && samplingDeadline == deadline;
+            });
+    }
+
+    pool.Wait(group);
+
+    for (int i = 0; i < int(components.size()); i++)
+    {
+        if (jobOf[i] != -1)
+            result[i] = jobs[jobOf[i]].result;
+    }
+
+    return result;
+}
+
+MineProbabilities FrontierSolver::Solve(const std::vector<Sentence>& knowledge, int unknownCount, int minesLeft,
+    std::chrono::steady_clock::time_point deadline)
+{
+    // References to the cached results must stay valid during the call
+    if (m_Cache.size() > MAX_CACHE_SIZE)
+        m_Cache.clear();
+
+    MineProbabilities result;
+
+    std::vector<FrontierComponent> components = SplitFrontier(knowledge);
+
+    std::vector<const ComponentLayouts*> layouts = Enumerate(components, minesLeft, deadline);
+
+    int frontierCount = 0;
+
+    for (int i = 0; i < int(components.size()); i++)
+    {
+        frontierCount += components[i].cells.size();
+
+        if (!layouts[i]->complete)
+            result.exact = false;
+
+        if (layouts[i]->sampled)
+            result.sampled = true;
+
+        if (layouts[i]->timedOut)
+            result.timedOut = true;
+    }
+
+    int otherCount = unknownCount - frontierCount;
+    result.otherCount = otherCount;
+
+    // ways[t] - number of ways (scaled) to place the mines that are not
+    // on the frontier if there are t mines on the frontier
+    std::vector<double> ways(minesLeft + 1, 0.0);
+    double maxLogWays = -std::numeric_limits<double>::infinity();
+
+    for (int t = 0; t <= minesLeft; t++)
+    {
+        int rest = minesLeft - t;
+
+        if (rest <= otherCount)
+        {
+            ways[t] = m_LogFactorials[otherCount] - m_LogFactorials[rest] - m_LogFactorials[otherCount - rest];
+            maxLogWays = std::max(maxLogWays, ways[t]);
+        }
+    }
+
+    for (int t = 0; t <= minesLeft; t++)
+    {
+        int rest = minesLeft - t;
+        ways[t] = (rest <= otherCount) ? std::exp(ways[t] - maxLogWays) : 0.0;
+    }
+
+    // prefix[i] and suffix[i] are the distributions of the number of mines
+    // in the components before i and starting from i
+    int componentsCount = components.size();
+
+    std::vector<std::vector<double>> prefix(componentsCount + 1);
+    std::vector<std::vector<double>> suffix(componentsCount + 1);
+
+    prefix[0] = { 1.0 };
+    suffix[componentsCount] = { 1.0 };
+
+    for (int i = 0; i < componentsCount; i++)
+        prefix[i + 1] = Convolve(prefix[i], layouts[i]->layouts, minesLeft + 1);
+
+    for (int i = componentsCount - 1; i >= 0; i--)
+        suffix[i] = Convolve(suffix[i + 1], layouts[i]->layouts, minesLeft + 1);
+
+    for (int i = 0; i < componentsCount; i++)
+    {
+        const auto& component = components[i];
+        const auto& layout = *layouts[i];
+
+        // Distribution of the mines in all other components
+        std::vector<double> others = Convolve(prefix[i], suffix[i + 1], minesLeft + 1);
+
+        std::vector<double> cellWeights(component.cells.size(), 0.0);
+        double totalWeight = 0.0;
+
+        for (int k = 0; k < int(layout.layouts.size()); k++)
+        {
+            if (layout.layouts[k] == 0.0)
+                continue;
+
+            // Weight of all layouts where this component has k mines
+            double weight = 0.0;
+
+            for (int s = 0; s < int(others.size()) && k + s <= minesLeft; s++)
+                weight += others[s] * ways[k + s];
+
+            totalWeight += layout.layouts[k] * weight;
+
+            for (int var = 0; var < int(component.cells.size()); var++)
+                cellWeights[var] += layout.mines[k][var] * weight;
+        }
+
+        for (int var = 0; var < int(component.cells.size()); var++)
+        {
+            result.cells.push_back(component.cells[var]);
+            result.probabilities.push_back(totalWeight > 0.0 ? cellWeights[var] / totalWeight : 0.5);
+        }
+    }
+
+    if (otherCount > 0)
+    {
+        // Expected number of mines outside of the frontier
+        const auto& all = prefix[componentsCount];
+
+        double totalWeight = 0.0;
+        double expectedMines = 0.0;
+
+        for (int s = 0; s < int(all.size()) && s <= minesLeft; s++)
+        {
+            totalWeight += all[s] * ways[s];
+            expectedMines += all[s] * ways[s] * (minesLeft - s);
+        }
+
+        result.otherProbability = totalWeight > 0.0 ? expectedMines / totalWeight / otherCount : 0.5;
+    }
+
+    return result;
+}
+
+void FrontierSolver::SetSamplingBudget(std::chrono::microseconds budget)
+{
+    m_SamplingBudget = budget;
+}
+
+std::chrono::microseconds FrontierSolver::GetSamplingBudget() const
+{
+    return m_SamplingBudget;
+}
@@ -1,91 +1,299 @@
 ﻿#include "../Include/Game.hpp"
 
-Minesweeper::Minesweeper(const def::Vector2i& boardSize, int minesCount)
-    : m_BoardSize(boardSize), m_MinesCount(minesCount)
+#include <algorithm>
+#include <cstring>
+
+Minesweeper::Minesweeper(const def::Vector2i& boardSize, int minesCount, Random random)
+    : m_BoardSize(boardSize), m_MinesCount(minesCount), m_Random(random)
 {
-    // Creating the board
-    m_Board = new Cell[boardSize.x * boardSize.y];
+    // Creating the board with a border of one cell on each side
+    m_Stride = boardSize.x + 2;
+    m_PaddedCount = m_Stride * (boardSize.y + 2);
 
-    // Populating the board with mines
+    m_Board = std::make_unique<Cell[]>(m_PaddedCount);
 
-    srand(time(nullptr));
+    PlaceMinesExcept(std::vector<int>());
+}
 
-    size_t minesCreated = 0;
-    while (minesCreated != minesCount)
-    {
-        int x = rand() % boardSize.x;
-        int y = rand() % boardSize.y;
+Minesweeper::Minesweeper(const def::Vector2i& boardSize, const std::vector<bool>& mines)
+    : m_BoardSize(boardSize), m_MinesCount(std::count(mines.begin(), mines.end(), true)), m_Random(0)
+{
+    m_Stride = boardSize.x + 2;
+    m_PaddedCount = m_Stride * (boardSize.y + 2);
+
+    m_Board = std::make_unique<Cell[]>(m_PaddedCount);
+
+    ClearBoard();
+
+    def::Vector2i cell;
+    for (cell.y = 0; cell.y < boardSize.y; cell.y++)
+        for (cell.x = 0; cell.x < boardSize.x; cell.x++)
+            m_Board[Index(cell)].isMine = mines[cell.y * boardSize.x + cell.x];
 
-        int i = y * boardSize.x + x;
+    FinishPlacement();
+}
+
+Minesweeper::Minesweeper(const Minesweeper& other)
+    : m_BoardSize(other.m_BoardSize), m_Stride(other.m_Stride), m_PaddedCount(other.m_PaddedCount)
+    , m_MinesCount(other.m_MinesCount), m_FlaggedMines(other.m_FlaggedMines)
+    , m_OpenOrFlagged(other.m_OpenOrFlagged), m_Random(other.m_Random)
+{
+    m_Board = std::make_unique_for_overwrite<Cell[]>(m_PaddedCount);
+    std::memcpy(m_Board.get(), other.m_Board.get(), m_PaddedCount * sizeof(Cell));
+}
+
+Minesweeper Minesweeper::Clone() const
+{
+    return Minesweeper(*this);
+}
 
-        if (!m_Board[i].isMine)
+void Minesweeper::PlaceMines(const def::Vector2i& safeCell)
+{
+    int cellsCount = m_BoardSize.x * m_BoardSize.y;
+
+    std::vector<int> excluded;
+
+    def::Vector2i pos;
+    for (pos.y = safeCell.y - 1; pos.y <= safeCell.y + 1; pos.y++)
+        for (pos.x = safeCell.x - 1; pos.x <= safeCell.x + 1; pos.x++)
         {
-            m_Board[i].isMine = true;
-            minesCreated++;
+            if (def::Vector2i(0, 0) <= pos && pos < m_BoardSize)
+                excluded.push_back(pos.y * m_BoardSize.x + pos.x);
         }
-    }
 
-    for (int y = 0; y < boardSize.y; y++)
-        for (int x = 0; x < boardSize.x; x++)
+    if (cellsCount - int(excluded.size()) < m_MinesCount)
+        excluded = { safeCell.y * m_BoardSize.x + safeCell.x };
+
+    if (cellsCount - int(excluded.size()) < m_MinesCount)
+        excluded.clear();
+
+    PlaceMinesExcept(excluded);
+}
+
+void Minesweeper::PlaceMinesExcept(const std::vector<int>& excluded)
+{
+    int cellsCount = m_BoardSize.x * m_BoardSize.y;
+
+    std::vector<bool> allowed(cellsCount, true);
+
+    for (int i : excluded)
+        allowed[i] = false;
+
+    ClearBoard();
+
+    // Cells that can have a mine, as indices on the padded board
+    std::vector<int> candidates;
+    candidates.reserve(cellsCount - excluded.size());
+
+    def::Vector2i cell;
+    for (cell.y = 0; cell.y < m_BoardSize.y; cell.y++)
+        for (cell.x = 0; cell.x < m_BoardSize.x; cell.x++)
         {
-            int i = y * boardSize.x + x;
-            m_Board[i].nearbyMinesCount = CountNearbyMines({ x, y });
+            if (allowed[cell.y * m_BoardSize.x + cell.x])
+                candidates.push_back(Index(cell));
         }
+
+    // After the i-th step the first i candidates are
+    // a uniformly chosen set of cells with mines
+    for (int i = 0; i < m_MinesCount; i++)
+    {
+        int j = i + m_Random.NextInt(int(candidates.size()) - i);
+        std::swap(candidates[i], candidates[j]);
+
+        m_Board[candidates[i]].isMine = true;
+    }
+
+    FinishPlacement();
 }
 
-Minesweeper::~Minesweeper()
+void Minesweeper::ClearBoard()
 {
-    delete[] m_Board;
+    // Keep the flags, the border is revealed so nothing ever opens it
+    for (int i = 0; i < m_PaddedCount; i++)
+    {
+        bool isFlagged = m_Board[i].isFlagged;
+
+        m_Board[i] = Cell();
+        m_Board[i].isFlagged = isFlagged;
+    }
+
+    for (int x = 0; x < m_Stride; x++)
+    {
+        m_Board[x].isRevealed = true;
+        m_Board[m_PaddedCount - 1 - x].isRevealed = true;
+    }
+
+    for (int y = 1; y <= m_BoardSize.y; y++)
+    {
+        m_Board[y * m_Stride].isRevealed = true;
+        m_Board[y * m_Stride + m_Stride - 1].isRevealed = true;
+    }
 }
 
-Cell& Minesweeper::GetCell(const def::Vector2i& cell)
+void Minesweeper::FinishPlacement()
 {
-    return m_Board[cell.y * m_BoardSize.x + cell.x];
+    m_FlaggedMines = 0;
+    m_OpenOrFlagged = 0;
+
+    for (int y = 1; y <= m_BoardSize.y; y++)
+        for (int x = 1; x <= m_BoardSize.x; x++)
+        {
+            const Cell& cell = m_Board[y * m_Stride + x];
+
+            m_FlaggedMines += cell.isFlagged && cell.isMine;
+            m_OpenOrFlagged += cell.isFlagged;
+        }
+
+    CountAllNearbyMines();
 }
 
-const Cell& Minesweeper::GetCell(const def::Vector2i& cell) const
+void Minesweeper::CountAllNearbyMines()
 {
-    return m_Board[cell.y * m_BoardSize.x + cell.x];
+    std::vector<uint8_t> mines(m_PaddedCount), rows(m_PaddedCount), counts(m_PaddedCount);
+
+    for (int i = 0; i < m_PaddedCount; i++)
+        mines[i] = m_Board[i].isMine;
+
+    // The border has no mines, so the sums of the cells inside
+    // the board need no bounds checks. The sums of the border itself
+    // wrap around the rows and are never used.
+    for (int i = 1; i < m_PaddedCount - 1; i++)
+        rows[i] = mines[i - 1] + mines[i] + mines[i + 1];
+
+    for (int i = m_Stride; i < m_PaddedCount - m_Stride; i++)
+        counts[i] = rows[i - m_Stride] + rows[i] + rows[i + m_Stride] - mines[i];
+
+    for (int y = 1; y <= m_BoardSize.y; y++)
+        for (int x = 1; x <= m_BoardSize.x; x++)
+        {
+            int i = y * m_Stride + x;
+            m_Board[i].nearbyMinesCount = counts[i];
+        }
 }
 
-bool Minesweeper::Won() const
+std::vector<std::pair<def::Vector2i, int>> Minesweeper::Reveal(const def::Vector2i& cell)
 {
-    int boardSize = m_BoardSize.x * m_BoardSize.y;
-    int minesIdentified = 0, revealed = 0;
+    std::vector<std::pair<def::Vector2i, int>> revealed;
+
+    // Opens a cell if it's closed and not flagged, the border
+    // is always open so the fill never leaves the board
+    auto open = [&](int i)
+        {
+            Cell& cell = m_Board[i];
+
+            if (cell.isRevealed || cell.isFlagged)
+                return false;
+
+            cell.isRevealed = true;
+            m_OpenOrFlagged++;
+
+            revealed.emplace_back(Position(i), int(cell.nearbyMinesCount));
+
+            return true;
+        };
+
+    auto isEmpty = [&](int i)
+        {
+            const Cell& cell = m_Board[i];
+            return !cell.isRevealed && !cell.isFlagged && !cell.isMine && cell.nearbyMinesCount == 0;
+        };
+
+    int start = Index(cell);
+
+    if (m_Board[start].isMine || !open(start) || m_Board[start].nearbyMinesCount != 0)
+        return revealed;
+
+    // Open empty cells that still need their neighbours opened
+    std::vector<int> seeds = { start };
 
-    for (int i = 0; i < boardSize; i++)
+    while (!seeds.empty())
     {
-        // If the cell is a mine and it's flagged
-        if (m_Board[i].isMine && m_Board[i].isFlagged)
-            minesIdentified++;
+        int seed = seeds.back();
+        seeds.pop_back();
 
-        if (m_Board[i].isRevealed || m_Board[i].isFlagged)
-            revealed++;
+        // Extend the seed to the whole span of empty cells in its row
+        int left = seed, right = seed;
+
+        while (isEmpty(left - 1))
+            open(--left);
+
+        while (isEmpty(right + 1))
+            open(++right);
+
+        // All neighbours of the empty cells are safe
+        open(left - 1);
+        open(right + 1);
+
+        for (int row : { -m_Stride, m_Stride })
+        {
+            for (int i = left - 1 + row; i <= right + 1 + row; i++)
+            {
+                if (open(i) && m_Board[i].nearbyMinesCount == 0)
+                    seeds.push_back(i);
+            }
+        }
     }
 
-    return minesIdentified == m_MinesCount && revealed == boardSize;
+    return revealed;
 }
-    
-int Minesweeper::CountNearbyMines(const def::Vector2i& cell) const
+
+void Minesweeper::SetFlag(const def::Vector2i& cell, bool flagged)
 {
-    int count = 0;
+    Cell& c = m_Board[Index(cell)];
 
-    static const def::Vector2i ORIGIN(0, 0);
+    if (c.isRevealed || c.isFlagged == flagged)
+        return;
 
-    def::Vector2i offset;
-    for (offset.y = -1; offset.y <= 1; offset.y++)
-        for (offset.x = -1; offset.x <= 1; offset.x++)
-        {
-            // Ignore the cell itself
-            if (offset == ORIGIN)
-                continue;
+    c.isFlagged = flagged;
 
-            def::Vector2i pos = cell + offset;
+    int change = flagged ? 1 : -1;
 
-            // Check if the cell is within the bounds and has a mine
-            if (ORIGIN <= pos && pos < m_BoardSize && GetCell(pos).isMine)
-                count++;
-        }
+    m_OpenOrFlagged += change;
+
+    if (c.isMine)
+        m_FlaggedMines += change;
+}
+
+void Minesweeper::ToggleFlag(const def::Vector2i& cell)
+{
+    SetFlag(cell, !GetCell(cell).isFlagged);
+}
+
+const def::Vector2i& Minesweeper::GetBoardSize() const
+{
+    return m_BoardSize;
+}
+
+int Minesweeper::GetMinesCount() const
+{
+    return m_MinesCount;
+}
+
+const Cell& Minesweeper::GetCell(const def::Vector2i& cell) const
+{
+    return m_Board[Index(cell)];
+}
+
+bool Minesweeper::Won() const
+{
+    return m_FlaggedMines == m_MinesCount && m_OpenOrFlagged == m_BoardSize.x * m_BoardSize.y;
+}
     
-    return count;
+int Minesweeper::CountNearbyMines(const def::Vector2i& cell) const
+{
+    int i = Index(cell);
+
+    return m_Board[i - m_Stride - 1].isMine + m_Board[i - m_Stride].isMine + m_Board[i - m_Stride + 1].isMine
+        + m_Board[i - 1].isMine + m_Board[i + 1].isMine
+        + m_Board[i + m_Stride - 1].isMine + m_Board[i + m_Stride].isMine + m_Board[i + m_Stride + 1].isMine;
+}
+
+int Minesweeper::Index(const def::Vector2i& cell) const
+{
+    return (cell.y + 1) * m_Stride + cell.x + 1;
+}
+
+def::Vector2i Minesweeper::Position(int index) const
+{
+    return { index % m_Stride - 1, index / m_Stride - 1 };
 }
\ No newline at end of file
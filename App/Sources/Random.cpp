@@ -0,0 +1,70 @@
+#include "../Include/Random.hpp"
+
+#include <bit>
+#include <random>
+
+Random::Random()
+{
+    std::random_device device;
+    uint64_t seed = (uint64_t(device()) << 32) | device();
+
+    for (auto& word : m_State)
+        word = SplitMix(seed);
+}
+
+Random::Random(uint64_t seed)
+{
+    for (auto& word : m_State)
+        word = SplitMix(seed);
+}
+
+uint64_t Random::Next()
+{
+    uint64_t result = std::rotl(m_State[1] * 5, 7) * 9;
+    uint64_t t = m_State[1] << 17;
+
+    m_State[2] ^= m_State[0];
+    m_State[3] ^= m_State[1];
+    m_State[1] ^= m_State[2];
+    m_State[0] ^= m_State[3];
+
+    m_State[2] ^= t;
+    m_State[3] = std::rotl(m_State[3], 45);
+
+    return result;
+}
+
+int Random::NextInt(int bound)
+{
+    // Multiplying by the bound maps the 32 high bits to [0, bound),
+    // the numbers that would make some results more likely are rejected
+    uint64_t product = (Next() >> 32) * uint64_t(bound);
+
+    if (uint32_t(product) < uint32_t(bound))
+    {
+        uint32_t threshold = uint32_t(-bound) % uint32_t(bound);
+
+        while (uint32_t(product) < threshold)
+            product = (Next() >> 32) * uint64_t(bound);
+    }
+
+    return int(product >> 32);
+}
+
+double Random::NextDouble()
+{
+    return (Next() >> 11) * 0x1.0p-53;
+}
+
+Random Random::Split()
+{
+    return Random(Next());
+}
+
+uint64_t Random::SplitMix(uint64_t& state)
+{
+    uint64_t z = (state += 0x9e3779b97f4a7c15);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+}
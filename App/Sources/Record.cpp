@@ -0,0 +1,251 @@
+#include "../Include/Record.hpp"
+
+#include <algorithm>
+
+namespace
+{
+    constexpr char MAGIC[3] = { 'M', 'S', 'G' };
+    // Logs of the first version had no guess strategy and are not read
+    constexpr uint8_t VERSION = 2;
+
+    // Marks the end of the moves of a game
+    constexpr uint8_t END_OF_GAME = 0xFF;
+}
+
+GameWriter::GameWriter(std::ostream& stream)
+    : m_Stream(stream) {}
+
+void GameWriter::BeginGame(const Minesweeper& game, uint64_t boardSeed, uint64_t aiSeed, DeductionEngine engine, GuessStrategy strategy)
+{
+    if (m_InGame)
+        EndGame(GameResult::Unfinished);
+
+    const def::Vector2i& boardSize = game.GetBoardSize();
+
+    m_Stream.write(MAGIC, sizeof(MAGIC));
+    m_Stream.put(VERSION);
+
+    WriteNumber(boardSeed);
+    WriteNumber(aiSeed);
+    WriteNumber(boardSize.x);
+    WriteNumber(boardSize.y);
+    WriteNumber(game.GetMinesCount());
+    WriteNumber(uint64_t(engine));
+    WriteNumber(uint64_t(strategy));
+
+    uint8_t byte = 0;
+    int bit = 0;
+
+    def::Vector2i cell;
+    for (cell.y = 0; cell.y < boardSize.y; cell.y++)
+        for (cell.x = 0; cell.x < boardSize.x; cell.x++)
+        {
+            if (game.GetCell(cell).isMine)
+                byte |= 1 << bit;
+
+            if (++bit == 8)
+            {
+                m_Stream.put(byte);
+                byte = 0;
+                bit = 0;
+            }
+        }
+
+    if (bit != 0)
+        m_Stream.put(byte);
+
+    m_InGame = true;
+
+    for (cell.y = 0; cell.y < boardSize.y; cell.y++)
+        for (cell.x = 0; cell.x < boardSize.x; cell.x++)
+        {
+            if (game.GetCell(cell).isFlagged)
+                AddMove(MoveKind::SetFlag, cell);
+        }
+}
+
+void GameWriter::AddMove(MoveKind kind, const def::Vector2i& cell)
+{
+    if (!m_InGame)
+        return;
+
+    m_Stream.put(uint8_t(kind));
+    WriteNumber(cell.x);
+    WriteNumber(cell.y);
+}
+
+void GameWriter::EndGame(GameResult result)
+{
+    if (!m_InGame)
+        return;
+
+    m_Stream.put(END_OF_GAME);
+    m_Stream.put(uint8_t(result));
+    m_Stream.flush();
+
+    m_InGame = false;
+}
+
+bool GameWriter::InGame() const
+{
+    return m_InGame;
+}
+
+void GameWriter::WriteNumber(uint64_t number)
+{
+    while (number >= 0x80)
+    {
+        m_Stream.put(uint8_t(number | 0x80));
+        number >>= 7;
+    }
+
+    m_Stream.put(uint8_t(number));
+}
+
+GameReader::GameReader(std::istream& stream)
+    : m_Stream(stream) {}
+
+bool GameReader::NextGame(GameHeader& header)
+{
+    MoveRecord move;
+
+    while (m_InGame && NextMove(move));
+
+    if (m_Corrupted || m_Stream.peek() == std::istream::traits_type::eof())
+        return false;
+
+    char magic[sizeof(MAGIC)];
+    uint8_t version;
+
+    m_Stream.read(magic, sizeof(magic));
+
+    if (!m_Stream || !std::equal(magic, magic + sizeof(magic), MAGIC) || !ReadByte(version) || version != VERSION)
+    {
+        m_Corrupted = true;
+        return false;
+    }
+
+    uint64_t width, height, minesCount, engine, strategy;
+
+    if (!ReadNumber(header.boardSeed) || !ReadNumber(header.aiSeed) || !ReadNumber(width) || !ReadNumber(height)
+        || !ReadNumber(minesCount) || !ReadNumber(engine) || engine > uint64_t(DeductionEngine::Elimination)
+        || !ReadNumber(strategy) || strategy > uint64_t(GuessStrategy::InformationGain)
+        || width == 0 || height == 0 || width > INT32_MAX || height > INT32_MAX
+        || width * height > INT32_MAX || minesCount > width * height)
+    {
+        m_Corrupted = true;
+        return false;
+    }
+
+    header.boardSize = def::Vector2i(width, height);
+    m_BoardSize = header.boardSize;
+    header.minesCount = minesCount;
+    header.engine = DeductionEngine(engine);
+    header.strategy = GuessStrategy(strategy);
+
+    int cellsCount = width * height;
+    header.mines.assign(cellsCount, false);
+
+    for (int i = 0; i < cellsCount; i += 8)
+    {
+        uint8_t byte;
+
+        if (!ReadByte(byte))
+            return false;
+
+        for (int bit = 0; bit < 8 && i + bit < cellsCount; bit++)
+            header.mines[i + bit] = (byte >> bit) & 1;
+    }
+
+    m_InGame = true;
+    m_Result = GameResult::Unfinished;
+
+    return true;
+}
+
+bool GameReader::NextMove(MoveRecord& move)
+{
+    if (!m_InGame)
+        return false;
+
+    uint8_t kind;
+
+    if (!ReadByte(kind))
+    {
+        m_InGame = false;
+        return false;
+    }
+
+    if (kind == END_OF_GAME)
+    {
+        uint8_t result;
+
+        if (!ReadByte(result) || result > uint8_t(GameResult::Lost))
+            m_Corrupted = true;
+        else
+            m_Result = GameResult(result);
+
+        m_InGame = false;
+        return false;
+    }
+
+    uint64_t x, y;
+
+    if (kind > uint8_t(MoveKind::ClearFlag) || !ReadNumber(x) || !ReadNumber(y)
+        || x >= uint64_t(m_BoardSize.x) || y >= uint64_t(m_BoardSize.y))
+    {
+        m_Corrupted = true;
+        m_InGame = false;
+        return false;
+    }
+
+    move.kind = MoveKind(kind);
+    move.cell = def::Vector2i(x, y);
+
+    return true;
+}
+
+GameResult GameReader::GetResult() const
+{
+    return m_Result;
+}
+
+bool GameReader::IsCorrupted() const
+{
+    return m_Corrupted;
+}
+
+bool GameReader::ReadNumber(uint64_t& number)
+{
+    number = 0;
+
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        uint8_t byte;
+
+        if (!ReadByte(byte))
+            return false;
+
+        number |= uint64_t(byte & 0x7F) << shift;
+
+        if ((byte & 0x80) == 0)
+            return true;
+    }
+
+    m_Corrupted = true;
+    return false;
+}
+
+bool GameReader::ReadByte(uint8_t& byte)
+{
+    int c = m_Stream.get();
+
+    if (c == std::istream::traits_type::eof())
+    {
+        m_Corrupted = true;
+        return false;
+    }
+
+    byte = c;
+    return true;
+}
@@ -0,0 +1,240 @@
+#include "../Include/Sampler.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace
+{
+    // The sums are scaled down when a weight gets this much bigger than the reference
+    constexpr int MAX_WEIGHT_EXPONENT = 512;
+}
+
+LayoutSampler::LayoutSampler(const FrontierComponent& component, int maxMines, uint64_t seed)
+    : m_Component(component), m_MaxMines(maxMines), m_Random(seed)
+{
+    int varsCount = component.cells.size();
+    int constraintsCount = component.constraints.size();
+
+    m_VarConstraints.resize(varsCount);
+    m_PlanesStart.resize(constraintsCount + 1);
+    m_Unassigned.resize(constraintsCount);
+    m_Values.resize(varsCount);
+
+    for (int c = 0; c < constraintsCount; c++)
+    {
+        const auto& constraint = component.constraints[c];
+
+        for (int var : constraint.vars)
+            m_VarConstraints[var].push_back(c);
+
+        // Enough planes to count all cells of the constraint
+        m_PlanesStart[c + 1] = m_PlanesStart[c] + std::bit_width(constraint.vars.size());
+    }
+
+    m_Planes.resize(m_PlanesStart[constraintsCount]);
+
+    // Breadth first search over the constraints, like the enumeration does
+    std::vector<bool> visited(varsCount);
+
+    for (int start = 0; start < varsCount; start++)
+    {
+        if (visited[start])
+            continue;
+
+        visited[start] = true;
+        m_Order.push_back(start);
+
+        for (int i = int(m_Order.size()) - 1; i < int(m_Order.size()); i++)
+        {
+            for (int c : m_VarConstraints[m_Order[i]])
+            {
+                for (int var : component.constraints[c].vars)
+                {
+                    if (!visited[var])
+                    {
+                        visited[var] = true;
+                        m_Order.push_back(var);
+                    }
+                }
+            }
+        }
+    }
+
+    m_Layouts.assign(maxMines + 1, 0.0);
+    m_Mines.assign(maxMines + 1, std::vector<double>(varsCount, 0.0));
+}
+
+void LayoutSampler::Run(std::chrono::steady_clock::time_point deadline, int64_t maxSamples)
+{
+    // At least one batch, so there is always some estimate
+    do
+    {
+        SampleBatch();
+    }
+    while (m_SamplesCount < maxSamples && std::chrono::steady_clock::now() < deadline);
+}
+
+ComponentLayouts LayoutSampler::GetLayouts() const
+{
+    ComponentLayouts result;
+    result.layouts = m_Layouts;
+    result.mines = m_Mines;
+    result.complete = false;
+    result.sampled = true;
+
+    double scale = 1.0 / std::max<int64_t>(m_SamplesCount, 1);
+
+    for (int k = 0; k < int(result.layouts.size()); k++)
+    {
+        result.layouts[k] *= scale;
+
+        for (double& mines : result.mines[k])
+            mines *= scale;
+    }
+
+    return result;
+}
+
+int64_t LayoutSampler::GetSamplesCount() const
+{
+    return m_SamplesCount;
+}
+
+void LayoutSampler::SampleBatch()
+{
+    std::ranges::fill(m_Planes, 0);
+
+    for (int c = 0; c < int(m_Component.constraints.size()); c++)
+        m_Unassigned[c] = m_Component.constraints[c].vars.size();
+
+    // Lanes that have not reached a dead end yet
+    uint64_t alive = ~uint64_t(0);
+
+    // Lanes that have placed all mines they can
+    uint64_t full = (m_MaxMines == 0) ? alive : 0;
+
+    int mines[LANES] = {};
+    int choices[LANES] = {};
+
+    for (int var : m_Order)
+    {
+        uint64_t canBeMine = alive & ~full;
+        uint64_t canBeSafe = alive;
+
+        for (int c : m_VarConstraints[var])
+        {
+            const auto& constraint = m_Component.constraints[c];
+
+            // A mine must not exceed the number of the constraint and a safe cell
+            // must leave enough unassigned cells to reach it
+            canBeMine &= LessThan(c, constraint.minesCount);
+            canBeSafe &= ~LessThan(c, constraint.minesCount - m_Unassigned[c] + 1);
+        }
+
+        uint64_t both = canBeMine & canBeSafe;
+        uint64_t value = (canBeMine & ~canBeSafe) | (both & m_Random.Next());
+
+        alive &= canBeMine | canBeSafe;
+        value &= alive;
+
+        m_Values[var] = value;
+
+        for (int c : m_VarConstraints[var])
+        {
+            AddMines(c, value);
+            m_Unassigned[c]--;
+        }
+
+        for (uint64_t bits = both; bits != 0; bits &= bits - 1)
+            choices[std::countr_zero(bits)]++;
+
+        for (uint64_t bits = value; bits != 0; bits &= bits - 1)
+        {
+            int lane = std::countr_zero(bits);
+
+            if (++mines[lane] == m_MaxMines)
+                full |= uint64_t(1) << lane;
+        }
+    }
+
+    for (uint64_t bits = alive; bits != 0; bits &= bits - 1)
+    {
+        int lane = std::countr_zero(bits);
+
+        if (m_Reference == -1)
+            m_Reference = choices[lane];
+
+        if (choices[lane] - m_Reference > MAX_WEIGHT_EXPONENT)
+        {
+            int shift = choices[lane] - m_Reference;
+
+            for (int k = 0; k < int(m_Layouts.size()); k++)
+            {
+                m_Layouts[k] = std::ldexp(m_Layouts[k], -shift);
+
+                for (double& mine : m_Mines[k])
+                    mine = std::ldexp(mine, -shift);
+            }
+
+            m_Reference += shift;
+        }
+
+        double weight = std::ldexp(1.0, choices[lane] - m_Reference);
+        int k = mines[lane];
+
+        m_Layouts[k] += weight;
+
+        for (int var = 0; var < int(m_Values.size()); var++)
+        {
+            if ((m_Values[var] >> lane) & 1)
+                m_Mines[k][var] += weight;
+        }
+    }
+
+    m_SamplesCount += LANES;
+}
+
+uint64_t LayoutSampler::LessThan(int constraint, int bound) const
+{
+    int start = m_PlanesStart[constraint];
+    int planesCount = m_PlanesStart[constraint + 1] - start;
+
+    if (bound <= 0)
+        return 0;
+
+    if (bound >= (1 << planesCount))
+        return ~uint64_t(0);
+
+    // Compare the numbers with the bound from the highest bit down
+    uint64_t less = 0;
+    uint64_t equal = ~uint64_t(0);
+
+    for (int b = planesCount - 1; b >= 0; b--)
+    {
+        uint64_t plane = m_Planes[start + b];
+
+        if ((bound >> b) & 1)
+        {
+            less |= equal & ~plane;
+            equal &= plane;
+        }
+        else
+            equal &= ~plane;
+    }
+
+    return less;
+}
+
+void LayoutSampler::AddMines(int constraint, uint64_t lanes)
+{
+    // Ripple carry adder over the bit planes
+    uint64_t carry = lanes;
+
+    for (int p = m_PlanesStart[constraint]; p < m_PlanesStart[constraint + 1] && carry != 0; p++)
+    {
+        uint64_t next = m_Planes[p] & carry;
+        m_Planes[p] ^= carry;
+        carry = next;
+    }
+}
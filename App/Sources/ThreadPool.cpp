@@ -0,0 +1,155 @@
+#include "../Include/ThreadPool.hpp"
+
+#include <algorithm>
+
+namespace
+{
+    // Index of the queue of the current thread if it's a worker
+    thread_local const ThreadPool* t_Pool = nullptr;
+    thread_local int t_WorkerIndex = -1;
+}
+
+bool TaskGroup::Done() const
+{
+    return m_Pending.load(std::memory_order_acquire) == 0;
+}
+
+ThreadPool::ThreadPool(int threadsCount)
+{
+    // There is always at least one queue so the tasks can be
+    // submitted even without workers and run by Wait
+    int queuesCount = std::max(threadsCount, 1);
+
+    for (int i = 0; i < queuesCount; i++)
+        m_Queues.push_back(std::make_unique<Queue>());
+
+    for (int i = 0; i < threadsCount; i++)
+        m_Threads.emplace_back(&ThreadPool::WorkerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock(m_SleepMutex);
+        m_Stop = true;
+    }
+
+    m_WakeUp.notify_all();
+
+    for (auto& thread : m_Threads)
+        thread.join();
+}
+
+ThreadPool& ThreadPool::Shared()
+{
+    static ThreadPool pool(std::max<int>(std::thread::hardware_concurrency(), 1) - 1);
+    return pool;
+}
+
+int ThreadPool::GetThreadsCount() const
+{
+    return m_Threads.size();
+}
+
+void ThreadPool::Submit(TaskGroup& group, Task task)
+{
+    group.m_Pending.fetch_add(1, std::memory_order_relaxed);
+
+    // Workers keep their own tasks close, other threads
+    // spread the tasks between the queues
+    int index = (t_Pool == this) ? t_WorkerIndex : m_NextQueue.fetch_add(1, std::memory_order_relaxed) % m_Queues.size();
+
+    {
+        std::lock_guard lock(m_Queues[index]->mutex);
+        m_Queues[index]->tasks.emplace_back(&group, std::move(task));
+    }
+
+    m_Queued.fetch_add(1, std::memory_order_release);
+
+    {
+        std::lock_guard lock(m_SleepMutex);
+    }
+
+    m_WakeUp.notify_one();
+}
+
+void ThreadPool::Wait(TaskGroup& group)
+{
+    int index = (t_Pool == this) ? t_WorkerIndex : -1;
+
+    while (!group.Done())
+    {
+        if (!RunTask(index, &group))
+            std::this_thread::yield();
+    }
+}
+
+void ThreadPool::WorkerLoop(int index)
+{
+    t_Pool = this;
+    t_WorkerIndex = index;
+
+    while (true)
+    {
+        if (RunTask(index))
+            continue;
+
+        std::unique_lock lock(m_SleepMutex);
+        m_WakeUp.wait(lock, [this]() { return m_Stop || m_Queued.load(std::memory_order_acquire) > 0; });
+
+        if (m_Stop)
+            return;
+    }
+}
+
+bool ThreadPool::RunTask(int index, const TaskGroup* group)
+{
+    std::pair<TaskGroup*, Task> task;
+    bool found = false;
+
+    auto matches = [group](const std::pair<TaskGroup*, Task>& queued) { return !group || queued.first == group; };
+
+    // Take the newest own task first
+    if (index >= 0)
+    {
+        auto& queue = *m_Queues[index];
+        std::lock_guard lock(queue.mutex);
+
+        auto it = std::find_if(queue.tasks.rbegin(), queue.tasks.rend(), matches);
+
+        if (it != queue.tasks.rend())
+        {
+            task = std::move(*it);
+            queue.tasks.erase(std::next(it).base());
+            found = true;
+        }
+    }
+
+    // Otherwise steal the oldest task of another queue
+    int queuesCount = m_Queues.size();
+
+    for (int i = 1; i <= queuesCount && !found; i++)
+    {
+        auto& queue = *m_Queues[(index + i + queuesCount) % queuesCount];
+        std::lock_guard lock(queue.mutex);
+
+        auto it = std::find_if(queue.tasks.begin(), queue.tasks.end(), matches);
+
+        if (it != queue.tasks.end())
+        {
+            task = std::move(*it);
+            queue.tasks.erase(it);
+            found = true;
+        }
+    }
+
+    if (!found)
+        return false;
+
+    m_Queued.fetch_sub(1, std::memory_order_relaxed);
+
+    task.second();
+    task.first->m_Pending.fetch_sub(1, std::memory_order_acq_rel);
+
+    return true;
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+/*
+Measures how the layout of a cell affects big boards: generating
+the board, scanning all of it and reading random cells. Build with and
+without the packed-cells option and compare the times, the random reads
+show the cost of the cache misses the most.
+
+Arguments: [width] [height] [mines density]
+*/
+int RunCellsBenchmark(int argc, char** argv);
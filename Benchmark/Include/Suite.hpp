@@ -0,0 +1,18 @@
+#pragma once
+
+/*
+Times the hot paths of the game and the AI on boards from 8x8
+to 1024x1024 with 10%, 20% and 30% of mines:
+
+    Sentence::MarkMine and Sentence::MarkSafe,
+    MinesweeperAI::AddKnowledge, MakeSafeMove and MakeRandomMove
+    while the AI plays a whole game with an oracle, like the engines benchmark does,
+    construction of Minesweeper and of MinesweeperAI.
+
+The results are printed and written as CSV, one row per benchmark:
+
+    benchmark,width,height,density,samples,mean_ns,p50_ns,p99_ns
+
+Arguments: [output path] (default benchmark.csv)
+*/
+int RunSuite(int argc, char** argv);
@@ -0,0 +1,65 @@
+#include "../Include/Cells.hpp"
+
+#include "Game.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+namespace
+{
+    double SecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int RunCellsBenchmark(int argc, char** argv)
+{
+    def::Vector2i boardSize(argc > 1 ? std::stoi(argv[1]) : 10000, argc > 2 ? std::stoi(argv[2]) : 10000);
+    double density = argc > 3 ? std::stod(argv[3]) : 0.2;
+
+    int64_t cellsCount = int64_t(boardSize.x) * boardSize.y;
+    int minesCount = cellsCount * density;
+
+    printf("%dx%d board, %lld cells, %d mines, %zu bytes per cell, %.1f MB\n",
+        boardSize.x, boardSize.y, (long long)cellsCount, minesCount, sizeof(Cell), cellsCount * sizeof(Cell) / 1e6);
+
+    auto start = std::chrono::steady_clock::now();
+    Minesweeper game(boardSize, minesCount, Random(1));
+    printf("Generation:   %8.3f s\n", SecondsSince(start));
+
+    // Won is constant time now, so the scan reads every cell itself
+    start = std::chrono::steady_clock::now();
+    int64_t minesAround = 0;
+
+    def::Vector2i cell;
+    for (cell.y = 0; cell.y < boardSize.y; cell.y++)
+        for (cell.x = 0; cell.x < boardSize.x; cell.x++)
+        {
+            const Cell& c = game.GetCell(cell);
+
+            if (!c.isMine)
+                minesAround += c.nearbyMinesCount;
+        }
+
+    printf("Full scan:    %8.3f s (%lld)\n", SecondsSince(start), (long long)minesAround);
+
+    // Every read depends on the previous one so the misses can't overlap
+    constexpr int READS_COUNT = 10'000'000;
+
+    Random random(2);
+    int sum = 0;
+
+    start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < READS_COUNT; i++)
+    {
+        def::Vector2i read((random.NextInt(boardSize.x) + sum) % boardSize.x, random.NextInt(boardSize.y));
+        sum = game.GetCell(read).nearbyMinesCount;
+    }
+
+    printf("Random reads: %8.2f ns per read (%d)\n", SecondsSince(start) * 1e9 / READS_COUNT, sum);
+
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include "../Include/Cells.hpp"
+#include "../Include/Suite.hpp"
+
+#include "Game.hpp"
+#include "AI.hpp"
+
+#include <string>
+
+/*
+Compares the deduction engines of the AI on the same boards.
+
+Each engine plays every board on its own: it makes safe moves while it
+knows any and when it doesn't, an oracle opens a random cell that is not
+a mine. The oracle uses the same random sequence for both engines, so
+the number of oracle moves shows how much each engine can deduce
+and the time shows how much the deductions cost.
+
+Run with "cells" as the first argument to measure the layout of the board instead
+and with "suite" to time the hot paths of the game and the AI.
+*/
+
+struct EngineResult
+{
+    int64_t oracleMoves = 0;
+    int64_t safeMoves = 0;
+    double seconds = 0.0;
+};
+
+void PlayWithOracle(const Minesweeper& game, const def::Vector2i& boardSize, int minesCount,
+    DeductionEngine engine, uint64_t seed, EngineResult& result)
+{
+    MinesweeperAI ai(boardSize, minesCount);
+    ai.SetDeductionEngine(engine);
+
+    Random oracle(seed);
+
+    std::vector<def::Vector2i> hidden;
+    std::vector<bool> revealed(boardSize.x * boardSize.y);
+
+    int safeCellsLeft = boardSize.x * boardSize.y - minesCount;
+
+    while (safeCellsLeft > 0)
+    {
+        std::optional<def::Vector2i> move = ai.MakeSafeMove();
+
+        if (move)
+            result.safeMoves++;
+        else
+        {
+            // Open a random cell that is not a mine
+            hidden.clear();
+
+            def::Vector2i c;
+            for (c.y = 0; c.y < boardSize.y; c.y++)
+                for (c.x = 0; c.x < boardSize.x; c.x++)
+                {
+                    if (!game.GetCell(c).isMine && !revealed[c.y * boardSize.x + c.x])
+                        hidden.push_back(c);
+                }
+
+            move = hidden[oracle.NextInt(int(hidden.size()))];
+            result.oracleMoves++;
+        }
+
+        revealed[move->y * boardSize.x + move->x] = true;
+        safeCellsLeft--;
+
+        auto start = std::chrono::steady_clock::now();
+        ai.AddKnowledge(*move, game.GetCell(*move).nearbyMinesCount);
+        result.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1 && std::string(argv[1]) == "cells")
+        return RunCellsBenchmark(argc - 1, argv + 1);
+
+    if (argc > 1 && std::string(argv[1]) == "suite")
+        return RunSuite(argc - 1, argv + 1);
+
+    int gamesCount = argc > 1 ? std::stoi(argv[1]) : 100;
+    def::Vector2i boardSize(argc > 2 ? std::stoi(argv[2]) : 30, argc > 3 ? std::stoi(argv[3]) : 16);
+    int minesCount = argc > 4 ? std::stoi(argv[4]) : 99;
+
+    EngineResult subset, elimination;
+
+    for (int i = 0; i < gamesCount; i++)
+    {
+        Minesweeper game(boardSize, minesCount, Random(i));
+
+        PlayWithOracle(game, boardSize, minesCount, DeductionEngine::Subset, i, subset);
+        PlayWithOracle(game, boardSize, minesCount, DeductionEngine::Elimination, i, elimination);
+    }
+
+    auto print = [&](const char* name, const EngineResult& result)
+        {
+            printf("%-12s oracle moves/game %8.2f  safe moves/game %8.2f  AddKnowledge %8.2f us/move\n",
+                name,
+                double(result.oracleMoves) / gamesCount,
+                double(result.safeMoves) / gamesCount,
+                result.seconds * 1e6 / (result.oracleMoves + result.safeMoves));
+        };
+
+    printf("%d games on %dx%d with %d mines\n", gamesCount, boardSize.x, boardSize.y, minesCount);
+    print("Subset", subset);
+    print("Elimination", elimination);
+
+    return 0;
+}
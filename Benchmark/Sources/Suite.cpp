@@ -0,0 +1,244 @@
+#include "../Include/Suite.hpp"
+
+#include "Game.hpp"
+#include "AI.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const def::Vector2i BOARD_SIZES[] = { { 8, 8 }, { 32, 32 }, { 128, 128 }, { 512, 512 }, { 1024, 1024 } };
+    const double DENSITIES[] = { 0.1, 0.2, 0.3 };
+
+    // Boards are constructed until this many are done or a second passes
+    constexpr int MAX_CONSTRUCTIONS = 1000;
+
+    using Clock = std::chrono::steady_clock;
+
+    double NanosecondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    }
+
+    struct Result
+    {
+        std::string benchmark;
+        def::Vector2i boardSize;
+        double density = 0.0;
+
+        int64_t samples = 0;
+        double mean = 0.0;
+        double p50 = 0.0;
+        double p99 = 0.0;
+    };
+
+    // Times of single calls, in nanoseconds
+    Result Summarize(const std::string& benchmark, const def::Vector2i& boardSize, double density, std::vector<double> times)
+    {
+        Result result{ benchmark, boardSize, density, int64_t(times.size()) };
+
+        if (times.empty())
+            return result;
+
+        std::ranges::sort(times);
+
+        for (double time : times)
+            result.mean += time;
+
+        result.mean /= times.size();
+        result.p50 = times[times.size() / 2];
+        result.p99 = times[std::min<size_t>(times.size() * 99 / 100, times.size() - 1)];
+
+        return result;
+    }
+
+    /*
+    Marks every cell of sentences like the ones AddKnowledge makes,
+    the time of one call is too short to measure on its own,
+    so each sample is the mean of a batch of calls.
+    */
+    void BenchmarkSentences(const def::Vector2i& boardSize, std::vector<Result>& results)
+    {
+        constexpr int BATCHES_COUNT = 200;
+        constexpr int BATCH_SIZE = 256;
+
+        CellSet cells;
+        def::Vector2i center = boardSize / 2;
+
+        def::Vector2i offset;
+        for (offset.y = -1; offset.y <= 1; offset.y++)
+            for (offset.x = -1; offset.x <= 1; offset.x++)
+            {
+                def::Vector2i cell = center + offset;
+
+                if (offset != def::Vector2i(0, 0) && def::Vector2i(0, 0) <= cell && cell < boardSize)
+                    cells.Insert(cell.y * boardSize.x + cell.x);
+            }
+
+        std::vector<int> indices;
+        cells.ForEach([&](int index) { indices.push_back(index); });
+
+        for (bool mines : { true, false })
+        {
+            std::vector<double> times;
+
+            for (int b = 0; b < BATCHES_COUNT; b++)
+            {
+                std::vector<Sentence> sentences(BATCH_SIZE, Sentence(cells, indices.size()));
+
+                auto start = Clock::now();
+
+                for (auto& sentence : sentences)
+                {
+                    for (int index : indices)
+                    {
+                        if (mines)
+                            sentence.MarkMine(index);
+                        else
+                            sentence.MarkSafe(index);
+                    }
+                }
+
+                times.push_back(NanosecondsSince(start) / (BATCH_SIZE * indices.size()));
+            }
+
+            results.push_back(Summarize(mines ? "Sentence::MarkMine" : "Sentence::MarkSafe", boardSize, 0.0, times));
+        }
+    }
+
+    void BenchmarkConstruction(const def::Vector2i& boardSize, double density, std::vector<Result>& results)
+    {
+        int minesCount = boardSize.x * boardSize.y * density;
+
+        std::vector<double> games, ais;
+
+        auto deadline = Clock::now() + std::chrono::seconds(1);
+
+        for (int i = 0; i < MAX_CONSTRUCTIONS && Clock::now() < deadline; i++)
+        {
+            auto start = Clock::now();
+            Minesweeper game(boardSize, minesCount, Random(i));
+            games.push_back(NanosecondsSince(start));
+
+            start = Clock::now();
+            MinesweeperAI ai(boardSize, minesCount, Random(i));
+            ais.push_back(NanosecondsSince(start));
+        }
+
+        results.push_back(Summarize("Minesweeper::Minesweeper", boardSize, density, games));
+        results.push_back(Summarize("MinesweeperAI::MinesweeperAI", boardSize, density, ais));
+    }
+
+    /*
+    Plays a game where the AI makes safe moves while it knows any
+    and an oracle opens a random cell without a mine otherwise,
+    so the AI never loses and every move is timed.
+    */
+    void BenchmarkMoves(const def::Vector2i& boardSize, double density, std::vector<Result>& results)
+    {
+        int minesCount = boardSize.x * boardSize.y * density;
+
+        Minesweeper game(boardSize, minesCount, Random(1));
+        MinesweeperAI ai(boardSize, minesCount, Random(2));
+
+        // The oracle takes the safe cells in a random order
+        std::vector<def::Vector2i> safeCells;
+
+        def::Vector2i c;
+        for (c.y = 0; c.y < boardSize.y; c.y++)
+            for (c.x = 0; c.x < boardSize.x; c.x++)
+            {
+                if (!game.GetCell(c).isMine)
+                    safeCells.push_back(c);
+            }
+
+        Random oracle(3);
+
+        for (int i = safeCells.size() - 1; i > 0; i--)
+            std::swap(safeCells[i], safeCells[oracle.NextInt(i + 1)]);
+
+        int safeCellsCount = safeCells.size();
+
+        std::vector<bool> opened(boardSize.x * boardSize.y);
+        std::vector<double> addKnowledge, safeMove, randomMove;
+
+        for (int moves = 0; moves < safeCellsCount; moves++)
+        {
+            auto start = Clock::now();
+            std::optional<def::Vector2i> move = ai.MakeRandomMove();
+            randomMove.push_back(NanosecondsSince(start));
+
+            start = Clock::now();
+            move = ai.MakeSafeMove();
+            safeMove.push_back(NanosecondsSince(start));
+
+            if (!move)
+            {
+                while (opened[safeCells.back().y * boardSize.x + safeCells.back().x])
+                    safeCells.pop_back();
+
+                move = safeCells.back();
+            }
+
+            opened[move->y * boardSize.x + move->x] = true;
+
+            start = Clock::now();
+            ai.AddKnowledge(*move, game.GetCell(*move).nearbyMinesCount);
+            addKnowledge.push_back(NanosecondsSince(start));
+        }
+
+        results.push_back(Summarize("MinesweeperAI::AddKnowledge", boardSize, density, addKnowledge));
+        results.push_back(Summarize("MinesweeperAI::MakeSafeMove", boardSize, density, safeMove));
+        results.push_back(Summarize("MinesweeperAI::MakeRandomMove", boardSize, density, randomMove));
+    }
+}
+
+int RunSuite(int argc, char** argv)
+{
+    std::string path = argc > 1 ? argv[1] : "benchmark.csv";
+
+    std::vector<Result> results;
+
+    for (const auto& boardSize : BOARD_SIZES)
+    {
+        BenchmarkSentences(boardSize, results);
+
+        for (double density : DENSITIES)
+        {
+            BenchmarkConstruction(boardSize, density, results);
+            BenchmarkMoves(boardSize, density, results);
+        }
+    }
+
+    std::ofstream file(path);
+
+    if (!file)
+    {
+        printf("Can't open %s\n", path.c_str());
+        return 1;
+    }
+
+    file << "benchmark,width,height,density,samples,mean_ns,p50_ns,p99_ns\n";
+
+    for (const auto& result : results)
+    {
+        char line[256];
+
+        snprintf(line, sizeof(line), "%s,%d,%d,%.2f,%lld,%.1f,%.1f,%.1f",
+            result.benchmark.c_str(), result.boardSize.x, result.boardSize.y, result.density,
+            (long long)result.samples, result.mean, result.p50, result.p99);
+
+        file << line << '\n';
+
+        printf("%-30s %5dx%-5d %3.0f%% %6lld samples  mean %12.1f ns  p50 %12.1f ns  p99 %12.1f ns\n",
+            result.benchmark.c_str(), result.boardSize.x, result.boardSize.y, result.density * 100.0,
+            (long long)result.samples, result.mean, result.p50, result.p99);
+    }
+
+    return 0;
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "Game.hpp"
+#include "AI.hpp"
+#include "Record.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+struct SimulationConfig
+{
+    def::Vector2i boardSize = { 30, 16 };
+    int minesCount = 99;
+
+    int64_t gamesCount = 1000;
+
+    // Game i is played with the generator seeded from a mix of the seed and i,
+    // so the results don't depend on the number of threads and runs
+    // with close seeds don't share games
+    uint64_t seed = 0;
+
+    // Zero means one thread per core
+    int threadsCount = 0;
+
+    DeductionEngine engine = DeductionEngine::Subset;
+    GuessStrategy strategy = GuessStrategy::LowestProbability;
+
+    // Time the AI has for every move, zero means no limit
+    std::chrono::microseconds moveBudget{ 0 };
+
+    // Writes all games to this file if it's not empty
+    std::string recordPath;
+};
+
+/*
+Counts of the move latencies in buckets that grow exponentially,
+so millions of moves take a fixed amount of memory
+and a percentile is off by at most the width of a bucket.
+*/
+class LatencyHistogram
+{
+public:
+    static constexpr int BUCKETS_PER_OCTAVE = 8;
+
+    // From 1 ns to about 18 minutes
+    static constexpr int OCTAVES_COUNT = 40;
+
+    LatencyHistogram();
+
+    void Add(double seconds);
+    void Merge(const LatencyHistogram& other);
+
+    // Returns the upper bound of the bucket that holds the percentile
+    double Percentile(double p) const;
+    double Max() const;
+
+private:
+    std::vector<int64_t> m_Counts;
+    int64_t m_Total = 0;
+    double m_Max = 0.0;
+
+};
+
+struct SimulationReport
+{
+    int64_t gamesCount = 0;
+    int64_t wins = 0;
+    int64_t moves = 0;
+
+    // Time of every move: choosing the cell, opening it
+    // and adding the opened cells to the knowledge base
+    LatencyHistogram latency;
+
+    // Numbers of the guesses by how complete the answer of the AI was
+    std::array<int64_t, int(AnswerCompleteness::Deduced)> guesses{};
+
+    double seconds = 0.0;
+
+    void Merge(const SimulationReport& other);
+};
+
+struct ReplayReport
+{
+    int64_t gamesCount = 0;
+    int64_t moves = 0;
+
+    // Games where the AI chose a different move than in the log
+    int64_t divergedGames = 0;
+
+    // Games that ended differently than in the log
+    int64_t resultMismatches = 0;
+
+    bool corrupted = false;
+
+    double seconds = 0.0;
+};
+
+/*
+Plays games of Minesweeper with the AI without any window.
+The AI makes a safe move if it knows one and the best guess otherwise,
+just like the "AI Move" button of the App, and the mines
+are placed after the first move so it is always safe.
+
+Games are spread over the threads one at a time through a shared counter.
+Each thread has its own report and the reports are merged
+after all threads have finished, so the threads never wait for each other.
+*/
+class Simulator
+{
+public:
+    Simulator(const SimulationConfig& config);
+
+    SimulationReport Run();
+
+    /*
+    Plays the recorded games again reading the log move by move.
+    The moves of the AI are checked against the moves it makes now,
+    so a change in the AI that makes it play differently is caught.
+    */
+    static ReplayReport Replay(std::istream& stream);
+
+    static void Print(const SimulationReport& report);
+    static void Print(const ReplayReport& report);
+
+private:
+    // Seed of the game with the index, mixed with splitmix64
+    uint64_t GetGameSeed(int64_t game) const;
+
+    // Returns true if the AI has opened all cells without mines,
+    // writes the game to the writer if there is one
+    bool PlayGame(uint64_t seed, SimulationReport& report, GameWriter* writer);
+
+private:
+    SimulationConfig m_Config;
+
+};
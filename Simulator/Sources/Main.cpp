@@ -0,0 +1,111 @@
+#include "../Include/Simulator.hpp"
+
+#include <cmath>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+void PrintUsage()
+{
+    printf(
+        "Usage: Simulator [options]\n"
+        "  --games N         number of games to play (default 1000)\n"
+        "  --width N         width of the board (default 30)\n"
+        "  --height N        height of the board (default 16)\n"
+        "  --mines N         number of mines (default 99)\n"
+        "  --seed N          seed of the run (default 0)\n"
+        "  --threads N       number of threads, 0 for one per core (default 0)\n"
+        "  --engine NAME     deduction engine: subset or elimination (default subset)\n"
+        "  --strategy NAME   guess strategy: random, lowest, corners or information\n"
+        "                    (default lowest)\n"
+        "  --budget MS       time the AI has for every move, 0 for no limit (default 0),\n"
+        "                    games played with a limit may not replay the same way\n"
+        "  --record PATH     write all games to a log\n"
+        "  --replay PATH     replay the games of a log instead of playing new ones\n");
+}
+
+int main(int argc, char** argv)
+{
+    SimulationConfig config;
+    std::string replayPath;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string_view arg = argv[i];
+
+        if (arg == "--help")
+        {
+            PrintUsage();
+            return 0;
+        }
+
+        if (i + 1 >= argc)
+        {
+            PrintUsage();
+            return 1;
+        }
+
+        std::string value = argv[++i];
+
+        if (arg == "--games")
+            config.gamesCount = std::stoll(value);
+        else if (arg == "--width")
+            config.boardSize.x = std::stoi(value);
+        else if (arg == "--height")
+            config.boardSize.y = std::stoi(value);
+        else if (arg == "--mines")
+            config.minesCount = std::stoi(value);
+        else if (arg == "--seed")
+            config.seed = std::stoull(value);
+        else if (arg == "--threads")
+            config.threadsCount = std::stoi(value);
+        else if (arg == "--budget")
+            config.moveBudget = std::chrono::microseconds(std::llround(std::stod(value) * 1000.0));
+        else if (arg == "--record")
+            config.recordPath = value;
+        else if (arg == "--replay")
+            replayPath = value;
+        else if (arg == "--engine" && value == "subset")
+            config.engine = DeductionEngine::Subset;
+        else if (arg == "--engine" && value == "elimination")
+            config.engine = DeductionEngine::Elimination;
+        else if (arg == "--strategy" && value == "random")
+            config.strategy = GuessStrategy::Random;
+        else if (arg == "--strategy" && value == "lowest")
+            config.strategy = GuessStrategy::LowestProbability;
+        else if (arg == "--strategy" && value == "corners")
+            config.strategy = GuessStrategy::Corners;
+        else if (arg == "--strategy" && value == "information")
+            config.strategy = GuessStrategy::InformationGain;
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    if (!replayPath.empty())
+    {
+        std::ifstream log(replayPath, std::ios::binary);
+
+        if (!log)
+        {
+            printf("Can't open %s\n", replayPath.c_str());
+            return 1;
+        }
+
+        Simulator::Print(Simulator::Replay(log));
+        return 0;
+    }
+
+    if (config.minesCount >= config.boardSize.x * config.boardSize.y)
+    {
+        printf("There must be fewer mines than cells\n");
+        return 1;
+    }
+
+    Simulator simulator(config);
+    Simulator::Print(simulator.Run());
+
+    return 0;
+}
@@ -0,0 +1,366 @@
+#include "../Include/Simulator.hpp"
+
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+LatencyHistogram::LatencyHistogram()
+    : m_Counts(BUCKETS_PER_OCTAVE * OCTAVES_COUNT) {}
+
+void LatencyHistogram::Add(double seconds)
+{
+    double nanoseconds = std::max(seconds * 1e9, 1.0);
+    int bucket = std::ceil(std::log2(nanoseconds) * BUCKETS_PER_OCTAVE);
+
+    m_Counts[std::clamp<int>(bucket, 0, m_Counts.size() - 1)]++;
+    m_Total++;
+    m_Max = std::max(m_Max, seconds);
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other)
+{
+    for (int i = 0; i < int(m_Counts.size()); i++)
+        m_Counts[i] += other.m_Counts[i];
+
+    m_Total += other.m_Total;
+    m_Max = std::max(m_Max, other.m_Max);
+}
+
+double LatencyHistogram::Percentile(double p) const
+{
+    int64_t rank = std::min<int64_t>(p * m_Total, m_Total - 1);
+
+    for (int i = 0; i < int(m_Counts.size()); i++)
+    {
+        rank -= m_Counts[i];
+
+        if (rank < 0)
+            return std::min(std::exp2(double(i) / BUCKETS_PER_OCTAVE) * 1e-9, m_Max);
+    }
+
+    return 0.0;
+}
+
+double LatencyHistogram::Max() const
+{
+    return m_Max;
+}
+
+void SimulationReport::Merge(const SimulationReport& other)
+{
+    gamesCount += other.gamesCount;
+    wins += other.wins;
+    moves += other.moves;
+    latency.Merge(other.latency);
+
+    for (int i = 0; i < int(guesses.size()); i++)
+        guesses[i] += other.guesses[i];
+}
+
+Simulator::Simulator(const SimulationConfig& config)
+    : m_Config(config) {}
+
+SimulationReport Simulator::Run()
+{
+    int threadsCount = m_Config.threadsCount;
+
+    if (threadsCount <= 0)
+        threadsCount = std::max<int>(std::thread::hardware_concurrency(), 1);
+
+    std::vector<SimulationReport> reports(threadsCount);
+    std::atomic<int64_t> nextGame = 0;
+
+    std::ofstream record;
+    std::mutex recordMutex;
+
+    if (!m_Config.recordPath.empty())
+    {
+        record.open(m_Config.recordPath, std::ios::binary);
+
+        if (!record.is_open())
+            printf("Can't open %s, the games are not recorded\n", m_Config.recordPath.c_str());
+    }
+
+    // The workers must not look at the state of the stream
+    // while another one is writing to it
+    const bool recording = record.is_open();
+
+    auto start = std::chrono::steady_clock::now();
+
+    auto worker = [&](SimulationReport& report)
+        {
+            while (true)
+            {
+                int64_t game = nextGame.fetch_add(1, std::memory_order_relaxed);
+
+                if (game >= m_Config.gamesCount)
+                    return;
+
+                bool won;
+
+                if (recording)
+                {
+                    // Games are written whole, so the games
+                    // of different threads never interleave
+                    std::ostringstream buffer;
+                    GameWriter writer(buffer);
+
+                    won = PlayGame(GetGameSeed(game), report, &writer);
+
+                    std::lock_guard lock(recordMutex);
+                    record.write(buffer.view().data(), buffer.view().size());
+                }
+                else
+                    won = PlayGame(GetGameSeed(game), report, nullptr);
+
+                if (won)
+                    report.wins++;
+
+                report.gamesCount++;
+            }
+        };
+
+    std::vector<std::thread> threads;
+
+    for (int i = 1; i < threadsCount; i++)
+        threads.emplace_back(worker, std::ref(reports[i]));
+
+    worker(reports[0]);
+
+    for (auto& thread : threads)
+        thread.join();
+
+    SimulationReport report;
+
+    for (const auto& threadReport : reports)
+        report.Merge(threadReport);
+
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return report;
+}
+
+uint64_t Simulator::GetGameSeed(int64_t game) const
+{
+    uint64_t state = m_Config.seed ^ (0x9e3779b97f4a7c15 * uint64_t(game));
+    return Random::SplitMix(state);
+}
+
+bool Simulator::PlayGame(uint64_t seed, SimulationReport& report, GameWriter* writer)
+{
+    Random random(seed);
+
+    uint64_t boardSeed = random.Next();
+    uint64_t aiSeed = random.Next();
+
+    Minesweeper game(m_Config.boardSize, m_Config.minesCount, Random(boardSeed));
+    MinesweeperAI ai(m_Config.boardSize, m_Config.minesCount, Random(aiSeed));
+
+    ai.SetDeductionEngine(m_Config.engine);
+    ai.SetGuessStrategy(m_Config.strategy);
+
+    int safeCellsLeft = m_Config.boardSize.x * m_Config.boardSize.y - m_Config.minesCount;
+    bool firstMove = true;
+
+    GameResult result = GameResult::Won;
+
+    while (safeCellsLeft > 0)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        auto deadline = (m_Config.moveBudget.count() > 0) ? start + m_Config.moveBudget : std::chrono::steady_clock::time_point::max();
+
+        BestMoveResult answer = ai.BestMove(deadline);
+        std::optional<def::Vector2i> move = answer.move;
+
+        if (!move)
+        {
+            result = GameResult::Unfinished;
+            break;
+        }
+
+        MoveKind kind = MoveKind::SafeMove;
+
+        if (answer.completeness != AnswerCompleteness::Deduced)
+        {
+            kind = MoveKind::GuessMove;
+            report.guesses[int(answer.completeness)]++;
+        }
+
+        report.moves++;
+
+        // Like in the App the first move never hits a mine
+        if (firstMove)
+        {
+            game.PlaceMines(*move);
+            firstMove = false;
+
+            if (writer)
+                writer->BeginGame(game, boardSeed, aiSeed, m_Config.engine, m_Config.strategy);
+        }
+
+        if (writer)
+            writer->AddMove(kind, *move);
+
+        if (game.GetCell(*move).isMine)
+        {
+            report.latency.Add(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            result = GameResult::Lost;
+            break;
+        }
+
+        auto revealed = game.Reveal(*move);
+        safeCellsLeft -= revealed.size();
+
+        ai.AddKnowledgeBatch(revealed);
+
+        report.latency.Add(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    // Like in the App the game is won once the mines that are left are flagged
+    if (result == GameResult::Won)
+    {
+        def::Vector2i cell;
+        for (cell.y = 0; cell.y < m_Config.boardSize.y; cell.y++)
+            for (cell.x = 0; cell.x < m_Config.boardSize.x; cell.x++)
+            {
+                if (game.GetCell(cell).isRevealed)
+                    continue;
+
+                game.SetFlag(cell, true);
+
+                if (writer)
+                    writer->AddMove(MoveKind::SetFlag, cell);
+            }
+
+        if (!game.Won())
+            result = GameResult::Unfinished;
+    }
+
+    if (writer)
+        writer->EndGame(result);
+
+    return result == GameResult::Won;
+}
+
+ReplayReport Simulator::Replay(std::istream& stream)
+{
+    ReplayReport report;
+
+    auto start = std::chrono::steady_clock::now();
+
+    GameReader reader(stream);
+    GameHeader header;
+
+    while (reader.NextGame(header))
+    {
+        Minesweeper game(header.boardSize, header.mines);
+        MinesweeperAI ai(header.boardSize, header.minesCount, Random(header.aiSeed));
+
+        ai.SetDeductionEngine(header.engine);
+        ai.SetGuessStrategy(header.strategy);
+
+        GameResult result = GameResult::Unfinished;
+        bool diverged = false;
+
+        MoveRecord move;
+        int64_t moveIndex = 0;
+
+        while (reader.NextMove(move))
+        {
+            report.moves++;
+            moveIndex++;
+
+            if (move.kind == MoveKind::SetFlag || move.kind == MoveKind::ClearFlag)
+            {
+                game.SetFlag(move.cell, move.kind == MoveKind::SetFlag);
+                continue;
+            }
+
+            // The AI must choose the same cell as when the game was recorded
+            if (move.kind != MoveKind::Open)
+            {
+                MoveKind kind = MoveKind::SafeMove;
+                std::optional<def::Vector2i> expected = ai.MakeSafeMove();
+
+                if (!expected)
+                {
+                    kind = MoveKind::GuessMove;
+                    expected = ai.MakeGuessMove();
+                }
+
+                if (!diverged && (kind != move.kind || expected != move.cell))
+                {
+                    printf("Game %lld diverged at move %lld: recorded %s, the AI chose %s\n",
+                        (long long)report.gamesCount, (long long)moveIndex, move.cell.ToString().c_str(),
+                        expected ? expected->ToString().c_str() : "nothing");
+
+                    diverged = true;
+                }
+            }
+
+            // Keep following the log after a divergence so the rest of the game still replays
+            if (result != GameResult::Unfinished)
+                continue;
+
+            if (game.GetCell(move.cell).isMine)
+                result = GameResult::Lost;
+            else
+            {
+                ai.AddKnowledgeBatch(game.Reveal(move.cell));
+            }
+        }
+
+        if (result == GameResult::Unfinished && game.Won())
+            result = GameResult::Won;
+
+        if (diverged)
+            report.divergedGames++;
+
+        if (!reader.IsCorrupted() && result != reader.GetResult())
+            report.resultMismatches++;
+
+        report.gamesCount++;
+    }
+
+    report.corrupted = reader.IsCorrupted();
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return report;
+}
+
+void Simulator::Print(const SimulationReport& report)
+{
+    auto microseconds = [&](double p)
+        {
+            return report.latency.Percentile(p) * 1e6;
+        };
+
+    double gamesCount = std::max<int64_t>(report.gamesCount, 1);
+
+    printf("Games:          %lld\n", (long long)report.gamesCount);
+    printf("Win rate:       %.2f%%\n", 100.0 * report.wins / gamesCount);
+    printf("Moves per game: %.2f\n", report.moves / gamesCount);
+    printf("Games/s:        %.2f\n", report.seconds > 0.0 ? report.gamesCount / report.seconds : 0.0);
+    printf("Move latency:   p50 %.2f us, p90 %.2f us, p99 %.2f us, max %.2f us\n",
+        microseconds(0.5), microseconds(0.9), microseconds(0.99), report.latency.Max() * 1e6);
+    printf("Guesses:        %lld exact, %lld sampled, %lld partial, %lld random by the strategy, %lld random after the deadline\n",
+        (long long)report.guesses[int(AnswerCompleteness::Exact)], (long long)report.guesses[int(AnswerCompleteness::Sampled)],
+        (long long)report.guesses[int(AnswerCompleteness::Partial)], (long long)report.guesses[int(AnswerCompleteness::Random)],
+        (long long)report.guesses[int(AnswerCompleteness::Fallback)]);
+}
+
+void Simulator::Print(const ReplayReport& report)
+{
+    printf("Games:          %lld\n", (long long)report.gamesCount);
+    printf("Moves:          %lld\n", (long long)report.moves);
+    printf("Diverged games: %lld\n", (long long)report.divergedGames);
+    printf("Other results:  %lld\n", (long long)report.resultMismatches);
+    printf("Games/s:        %.2f\n", report.seconds > 0.0 ? report.gamesCount / report.seconds : 0.0);
+
+    if (report.corrupted)
+        printf("The log ends in the middle of a game or has invalid data\n");
+}
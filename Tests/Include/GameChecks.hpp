@@ -0,0 +1,18 @@
+#pragma once
+
+/*
+Checks of the board and of how the AI takes in the opened cells.
+Every check prints what went wrong and returns false on a failure.
+*/
+
+// Minesweeper::Reveal against a breadth first search over the board,
+// on boards of many sizes with some flags on them
+bool CheckRevealAgainstBfs();
+
+// AddKnowledgeBatch must deduce the same mines as adding
+// the same cells one at a time with AddKnowledge
+bool CheckBatchKnowledge();
+
+// The elimination engine must deduce every cell the subset engine does
+// and neither of them may deduce a wrong cell
+bool CheckEliminationAgainstSubset();
@@ -0,0 +1,17 @@
+#pragma once
+
+/*
+Checks of the probabilities that the AI guesses with.
+Every check prints what went wrong and returns false on a failure.
+*/
+
+// FrontierSolver::Solve against counting every placement of the mines
+// on small boards as more and more of their cells are opened
+bool CheckSolverAgainstBruteForce();
+
+// FrontierSolver::Enumerate on components big enough to be split between
+// the workers against a plain backtracking count of the layouts
+bool CheckSplitEnumeration();
+
+// Marginals of LayoutSampler against the exact ones of the same components
+bool CheckSamplerMarginals();
@@ -0,0 +1,207 @@
+#include "../Include/GameChecks.hpp"
+
+#include "AI.hpp"
+#include "Game.hpp"
+
+#include <cstdio>
+#include <vector>
+
+bool CheckRevealAgainstBfs()
+{
+    for (int g = 0; g < 3000; g++)
+    {
+        Random random(g);
+
+        // Every shape from a single cell to a long row, up to a quarter of mines
+        def::Vector2i boardSize(1 + g % 23, 1 + (g / 7) % 19);
+        int cellsCount = boardSize.x * boardSize.y;
+
+        Minesweeper game(boardSize, cellsCount * (g % 5) / 20, Random(g));
+
+        for (int i = 0; i < g % 3; i++)
+            game.SetFlag({ random.NextInt(boardSize.x), random.NextInt(boardSize.y) }, true);
+
+        def::Vector2i start(random.NextInt(boardSize.x), random.NextInt(boardSize.y));
+
+        // Cells that the reference search opens, found before the board changes
+        std::vector<bool> expected(cellsCount);
+        std::vector<def::Vector2i> stack;
+        int expectedCount = 0;
+
+        auto open = [&](const def::Vector2i& c)
+        {
+            const Cell& cell = game.GetCell(c);
+            int index = c.y * boardSize.x + c.x;
+
+            if (cell.isMine || cell.isFlagged || cell.isRevealed || expected[index])
+                return;
+
+            expected[index] = true;
+            expectedCount++;
+
+            if (cell.nearbyMinesCount == 0)
+                stack.push_back(c);
+        };
+
+        open(start);
+
+        while (!stack.empty())
+        {
+            def::Vector2i c = stack.back();
+            stack.pop_back();
+
+            for (int dy = -1; dy <= 1; dy++)
+                for (int dx = -1; dx <= 1; dx++)
+                {
+                    def::Vector2i n(c.x + dx, c.y + dy);
+
+                    if (n.x >= 0 && n.y >= 0 && n.x < boardSize.x && n.y < boardSize.y)
+                        open(n);
+                }
+        }
+
+        std::vector<std::pair<def::Vector2i, int>> revealed = game.Reveal(start);
+        std::vector<bool> seen(cellsCount);
+
+        for (const auto& [c, count] : revealed)
+        {
+            int index = c.y * boardSize.x + c.x;
+            const Cell& cell = game.GetCell(c);
+
+            if (!expected[index] || seen[index] || !cell.isRevealed || count != cell.nearbyMinesCount)
+            {
+                printf("  board %d: wrong cell %d %d was opened\n", g, c.x, c.y);
+                return false;
+            }
+
+            seen[index] = true;
+        }
+
+        if (int(revealed.size()) != expectedCount)
+        {
+            printf("  board %d: %d cells were opened instead of %d\n", g, int(revealed.size()), expectedCount);
+            return false;
+        }
+    }
+
+    printf("  3000 boards match\n");
+    return true;
+}
+
+bool CheckBatchKnowledge()
+{
+    def::Vector2i boardSize(100, 100);
+    def::Vector2i start(15, 8);
+    int minesCount = 1600;
+
+    for (int g = 0; g < 20; g++)
+    {
+        Minesweeper game(boardSize, minesCount, Random(g));
+        game.PlaceMines(start);
+
+        MinesweeperAI batch(boardSize, minesCount, Random(1));
+        MinesweeperAI single(boardSize, minesCount, Random(1));
+
+        std::vector<std::pair<def::Vector2i, int>> revealed = game.Reveal(start);
+
+        batch.AddKnowledgeBatch(revealed);
+
+        for (const auto& [c, count] : revealed)
+            single.AddKnowledge(c, count);
+
+        const BitBoard& batchMines = batch.GetKnownMines();
+        const BitBoard& singleMines = single.GetKnownMines();
+
+        if (batchMines.Count() != singleMines.Count())
+        {
+            printf("  board %d: %d mines in a batch and %d one by one\n", g, batchMines.Count(), singleMines.Count());
+            return false;
+        }
+
+        for (def::Vector2i mine : batchMines)
+        {
+            if (!singleMines.Contains(mine) || !game.GetCell(mine).isMine)
+            {
+                printf("  board %d: cell %d %d is not a mine\n", g, mine.x, mine.y);
+                return false;
+            }
+        }
+    }
+
+    printf("  20 boards match\n");
+    return true;
+}
+
+bool CheckEliminationAgainstSubset()
+{
+    int64_t deductions = 0;
+
+    for (int g = 0; g < 300; g++)
+    {
+        Random random(g);
+
+        def::Vector2i boardSize(4 + g % 17, 4 + (g / 17) % 13);
+        int cellsCount = boardSize.x * boardSize.y;
+        int minesCount = cellsCount * (10 + g % 15) / 100;
+
+        Minesweeper game(boardSize, minesCount, Random(g));
+
+        MinesweeperAI subset(boardSize, minesCount, Random(1));
+        MinesweeperAI elimination(boardSize, minesCount, Random(1));
+
+        subset.SetDeductionEngine(DeductionEngine::Subset);
+        elimination.SetDeductionEngine(DeductionEngine::Elimination);
+
+        // Half of the cells without mines are opened in a random order,
+        // so both engines see many scattered numbers at once
+        std::vector<def::Vector2i> order;
+
+        def::Vector2i c;
+        for (c.y = 0; c.y < boardSize.y; c.y++)
+            for (c.x = 0; c.x < boardSize.x; c.x++)
+            {
+                if (!game.GetCell(c).isMine)
+                    order.push_back(c);
+            }
+
+        for (int i = int(order.size()) - 1; i > 0; i--)
+            std::swap(order[i], order[random.NextInt(i + 1)]);
+
+        for (int step = 0; step < int(order.size()) / 2; step++)
+        {
+            int count = game.GetCell(order[step]).nearbyMinesCount;
+
+            subset.AddKnowledge(order[step], count);
+            elimination.AddKnowledge(order[step], count);
+
+            for (c.y = 0; c.y < boardSize.y; c.y++)
+                for (c.x = 0; c.x < boardSize.x; c.x++)
+                {
+                    bool isMine = game.GetCell(c).isMine;
+
+                    bool subsetMine = subset.GetKnownMines().Contains(c);
+                    bool subsetSafe = subset.GetKnownSafes().Contains(c);
+                    bool eliminationMine = elimination.GetKnownMines().Contains(c);
+                    bool eliminationSafe = elimination.GetKnownSafes().Contains(c);
+
+                    if ((subsetMine && !eliminationMine) || (subsetSafe && !eliminationSafe))
+                    {
+                        printf("  board %d: only the subset engine knows cell %d %d\n", g, c.x, c.y);
+                        return false;
+                    }
+
+                    if (((subsetMine || eliminationMine) && !isMine) || ((subsetSafe || eliminationSafe) && isMine))
+                    {
+                        printf("  board %d: cell %d %d was deduced wrong\n", g, c.x, c.y);
+                        return false;
+                    }
+                }
+
+            deductions += elimination.GetKnownMines().Count() + elimination.GetKnownSafes().Count()
+                - subset.GetKnownMines().Count() - subset.GetKnownSafes().Count();
+        }
+    }
+
+    printf("  300 boards match, the elimination engine knew %lld more cells over all steps\n", (long long)deductions);
+    return true;
+}
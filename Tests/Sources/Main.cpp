@@ -0,0 +1,50 @@
+#include "../Include/GameChecks.hpp"
+#include "../Include/SolverChecks.hpp"
+
+#include <cstdio>
+#include <iterator>
+
+/*
+Checks the game and the AI against simple
+reference implementations on many random boards and components.
+
+All checks use fixed seeds, so a failure can be reproduced.
+Returns a non-zero code if any check fails.
+*/
+
+struct Check
+{
+    const char* name;
+    bool (*run)();
+};
+
+int main()
+{
+    const Check checks[] =
+    {
+        { "Solver against brute force", CheckSolverAgainstBruteForce },
+        { "Split enumeration against backtracking", CheckSplitEnumeration },
+        { "Reveal against a breadth first search", CheckRevealAgainstBfs },
+        { "AddKnowledgeBatch against AddKnowledge", CheckBatchKnowledge },
+        { "Elimination engine against the subset engine", CheckEliminationAgainstSubset },
+        { "Sampler marginals against exact ones", CheckSamplerMarginals }
+    };
+
+    int failed = 0;
+
+    for (const Check& check : checks)
+    {
+        printf("%s\n", check.name);
+
+        if (!check.run())
+        {
+            printf("  FAILED\n");
+            failed++;
+        }
+    }
+
+    int checksCount = std::size(checks);
+
+    printf("%d of %d checks passed\n", checksCount - failed, checksCount);
+    return failed == 0 ? 0 : 1;
+}
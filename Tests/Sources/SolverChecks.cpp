@@ -0,0 +1,363 @@
+#include "../Include/SolverChecks.hpp"
+
+#include "AI.hpp"
+#include "Frontier.hpp"
+#include "Sampler.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <random>
+
+namespace
+{
+    constexpr double EXACT_TOLERANCE = 1e-9;
+
+    // The random components have many dead ends, so the sampler is given more
+    // samples than the solver gives it and its error is then well below the tolerance
+    constexpr int64_t SAMPLES_COUNT = 1 << 22;
+    constexpr double SAMPLED_TOLERANCE = 0.02;
+
+    // Brute force goes through all placements of the mines in the unknown cells
+    constexpr int MAX_BRUTE_FORCE_CELLS = 20;
+
+    // Returns the next bigger number with the same number of set bits
+    uint32_t NextSubset(uint32_t subset)
+    {
+        uint32_t lowest = subset & -subset;
+        uint32_t ripple = subset + lowest;
+
+        return (((ripple ^ subset) >> 2) / lowest) | ripple;
+    }
+
+    // Random component: overlapping windows of 2 to 4 cells along a chain,
+    // with the numbers taken from a random layout so it has a solution
+    FrontierComponent MakeChainComponent(int cellsCount, std::mt19937& random)
+    {
+        FrontierComponent component;
+        std::vector<bool> mines(cellsCount);
+
+        for (int i = 0; i < cellsCount; i++)
+        {
+            component.cells.push_back(i);
+            mines[i] = random() % 100 < 30;
+        }
+
+        for (int start = 0; start + 1 < cellsCount; start += 1 + random() % 2)
+        {
+            FrontierComponent::Constraint constraint{ {}, 0 };
+            int end = std::min<int>(cellsCount, start + 2 + random() % 3);
+
+            for (int var = start; var < end; var++)
+            {
+                constraint.vars.push_back(var);
+                constraint.minesCount += mines[var];
+            }
+
+            component.constraints.push_back(constraint);
+        }
+
+        return component;
+    }
+
+    // Counts the layouts of the component by backtracking over the cells
+    ComponentLayouts CountLayouts(const FrontierComponent& component, int maxMines)
+    {
+        int varsCount = component.cells.size();
+
+        ComponentLayouts result;
+        result.layouts.assign(maxMines + 1, 0.0);
+        result.mines.assign(maxMines + 1, std::vector<double>(varsCount, 0.0));
+
+        std::vector<bool> values(varsCount);
+
+        // A constraint is checked once its last cell is assigned
+        std::vector<std::vector<int>> finished(varsCount);
+
+        for (int c = 0; c < int(component.constraints.size()); c++)
+        {
+            const auto& vars = component.constraints[c].vars;
+            finished[*std::max_element(vars.begin(), vars.end())].push_back(c);
+        }
+
+        std::function<void(int, int)> assign = [&](int var, int mines)
+        {
+            if (var == varsCount)
+            {
+                result.layouts[mines]++;
+
+                for (int i = 0; i < varsCount; i++)
+                {
+                    if (values[i])
+                        result.mines[mines][i]++;
+                }
+
+                return;
+            }
+
+            for (int value = 0; value <= 1 && mines + value <= maxMines; value++)
+            {
+                values[var] = value;
+
+                bool valid = true;
+
+                for (int c : finished[var])
+                {
+                    int count = 0;
+
+                    for (int v : component.constraints[c].vars)
+                        count += values[v];
+
+                    if (count != component.constraints[c].minesCount)
+                        valid = false;
+                }
+
+                if (valid)
+                    assign(var + 1, mines + value);
+            }
+        };
+
+        assign(0, 0);
+        return result;
+    }
+
+    // Probability of a mine in every cell of the component
+    // when any number of mines is allowed
+    std::vector<double> GetMarginals(const ComponentLayouts& layouts)
+    {
+        std::vector<double> marginals(layouts.mines[0].size());
+        double total = 0.0;
+
+        for (int k = 0; k < int(layouts.layouts.size()); k++)
+        {
+            total += layouts.layouts[k];
+
+            for (int i = 0; i < int(marginals.size()); i++)
+                marginals[i] += layouts.mines[k][i];
+        }
+
+        for (double& marginal : marginals)
+            marginal /= total;
+
+        return marginals;
+    }
+}
+
+bool CheckSolverAgainstBruteForce()
+{
+    constexpr int WIDTH = 5;
+    constexpr int HEIGHT = 5;
+    constexpr int MINES = 7;
+    constexpr int CELLS = WIDTH * HEIGHT;
+
+    // The solver is reused across the boards so its cache is checked too
+    FrontierSolver solver(CELLS);
+    int checks = 0;
+
+    for (int g = 0; g < 200; g++)
+    {
+        std::mt19937 random(g);
+
+        // A random layout of the mines and a random order to open the other cells in
+        std::vector<int> order(CELLS);
+        std::vector<bool> mines(CELLS);
+
+        for (int i = 0; i < CELLS; i++)
+            order[i] = i;
+
+        for (int i = 0; i < CELLS; i++)
+            std::swap(order[i], order[i + random() % (CELLS - i)]);
+
+        for (int i = 0; i < MINES; i++)
+            mines[order[i]] = true;
+
+        std::vector<bool> opened(CELLS);
+
+        for (int step = MINES; step < CELLS; step++)
+        {
+            opened[order[step]] = true;
+
+            // Every open cell tells the number of mines among its closed neighbours
+            std::vector<int> unknown;
+            std::vector<Sentence> knowledge;
+
+            for (int i = 0; i < CELLS; i++)
+            {
+                if (!opened[i])
+                {
+                    unknown.push_back(i);
+                    continue;
+                }
+
+                CellSet neighbours;
+                int minesCount = 0;
+
+                for (int dy = -1; dy <= 1; dy++)
+                    for (int dx = -1; dx <= 1; dx++)
+                    {
+                        int x = i % WIDTH + dx;
+                        int y = i / WIDTH + dy;
+
+                        if (x < 0 || y < 0 || x >= WIDTH || y >= HEIGHT || opened[y * WIDTH + x])
+                            continue;
+
+                        neighbours.Insert(y * WIDTH + x);
+                        minesCount += mines[y * WIDTH + x];
+                    }
+
+                if (!neighbours.Empty())
+                    knowledge.emplace_back(neighbours, minesCount);
+            }
+
+            int unknownCount = unknown.size();
+
+            if (unknownCount > MAX_BRUTE_FORCE_CELLS)
+                continue;
+
+            // The sentences as masks over the positions in 'unknown'
+            std::vector<int> positions(CELLS);
+            std::vector<std::pair<uint32_t, int>> constraints;
+
+            for (int i = 0; i < unknownCount; i++)
+                positions[unknown[i]] = i;
+
+            for (const Sentence& sentence : knowledge)
+            {
+                uint32_t vars = 0;
+                sentence.cells.ForEach([&](int i) { vars |= uint32_t(1) << positions[i]; });
+                constraints.emplace_back(vars, sentence.minesCount);
+            }
+
+            // Every placement of the mines in the unknown cells
+            // that gives the same numbers in the open cells
+            std::vector<double> counts(unknownCount);
+            double total = 0.0;
+
+            for (uint32_t mask = (uint32_t(1) << MINES) - 1; mask < (uint32_t(1) << unknownCount); mask = NextSubset(mask))
+            {
+                bool valid = true;
+
+                for (const auto& [vars, minesCount] : constraints)
+                {
+                    if (std::popcount(mask & vars) != minesCount)
+                    {
+                        valid = false;
+                        break;
+                    }
+                }
+
+                if (!valid)
+                    continue;
+
+                total++;
+
+                for (int i = 0; i < unknownCount; i++)
+                    counts[i] += (mask >> i) & 1;
+            }
+
+            MineProbabilities solved = solver.Solve(knowledge, unknownCount, MINES);
+
+            if (!solved.exact || solved.sampled)
+            {
+                printf("  board %d: a small board was not solved exactly\n", g);
+                return false;
+            }
+
+            std::vector<double> probabilities(CELLS, solved.otherProbability);
+
+            for (int i = 0; i < int(solved.cells.size()); i++)
+                probabilities[solved.cells[i]] = solved.probabilities[i];
+
+            for (int i = 0; i < unknownCount; i++)
+            {
+                double expected = counts[i] / total;
+                double probability = probabilities[unknown[i]];
+
+                if (std::abs(probability - expected) > EXACT_TOLERANCE)
+                {
+                    printf("  board %d: cell %d has %f instead of %f\n", g, unknown[i], probability, expected);
+                    return false;
+                }
+
+                checks++;
+            }
+        }
+    }
+
+    printf("  %d probabilities match\n", checks);
+    return true;
+}
+
+bool CheckSplitEnumeration()
+{
+    std::mt19937 random(1);
+
+    for (int cellsCount = FrontierSolver::SPLIT_MIN_CELLS + 2; cellsCount <= 40; cellsCount += 2)
+    {
+        FrontierComponent component = MakeChainComponent(cellsCount, random);
+
+        // Also with fewer mines allowed than the component can hold
+        for (int maxMines : { cellsCount, cellsCount / 4 })
+        {
+            FrontierSolver solver(cellsCount);
+            const ComponentLayouts& layouts = *solver.Enumerate({ component }, maxMines)[0];
+            ComponentLayouts expected = CountLayouts(component, maxMines);
+
+            if (!layouts.complete || int(layouts.layouts.size()) != maxMines + 1)
+            {
+                printf("  %d cells: the enumeration is not complete\n", cellsCount);
+                return false;
+            }
+
+            for (int k = 0; k <= maxMines; k++)
+            {
+                if (layouts.layouts[k] != expected.layouts[k] || layouts.mines[k] != expected.mines[k])
+                {
+                    printf("  %d cells, at most %d mines: wrong counts of layouts with %d mines\n",
+                        cellsCount, maxMines, k);
+                    return false;
+                }
+            }
+        }
+    }
+
+    printf("  components of %d to 40 cells match\n", FrontierSolver::SPLIT_MIN_CELLS + 2);
+    return true;
+}
+
+bool CheckSamplerMarginals()
+{
+    std::mt19937 random(2);
+    double maxError = 0.0;
+
+    for (int cellsCount = 20; cellsCount <= 40; cellsCount += 4)
+    {
+        FrontierComponent component = MakeChainComponent(cellsCount, random);
+
+        FrontierSolver solver(cellsCount);
+        std::vector<double> expected = GetMarginals(*solver.Enumerate({ component }, cellsCount)[0]);
+
+        // A fixed seed and number of samples, so the check always gives the same result
+        LayoutSampler sampler(component, cellsCount, cellsCount);
+        sampler.Run(std::chrono::steady_clock::time_point::max(), SAMPLES_COUNT);
+
+        std::vector<double> sampled = GetMarginals(sampler.GetLayouts());
+
+        for (int i = 0; i < cellsCount; i++)
+        {
+            double error = std::abs(sampled[i] - expected[i]);
+            maxError = std::max(maxError, error);
+
+            if (error > SAMPLED_TOLERANCE)
+            {
+                printf("  %d cells: cell %d has %f instead of %f\n", cellsCount, i, sampled[i], expected[i]);
+                return false;
+            }
+        }
+    }
+
+    printf("  the largest error of a marginal is %.4f\n", maxError);
+    return true;
+}
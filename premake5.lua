@@ -1,4 +1,10 @@
 ---@diagnostic disable: undefined-global
+newoption
+{
+    trigger = "packed-cells",
+    description = "Store every cell of the board in one byte"
+}
+
 workspace "MinesweeperAI"
     startproject "App"
 
@@ -14,6 +20,11 @@ workspace "MinesweeperAI"
     filter "system:macosx"
         architecture "ARM64"
 
+    filter "options:packed-cells"
+        defines { "MINESWEEPER_PACKED_CELLS" }
+
+    filter {}
+
 OUTPUT_DIR = "%{cfg.buildcfg}-%{cfg.system}-%{cfg.architecture}"
 
 include "Engine/Vendor/glfw"
@@ -196,3 +207,68 @@ project "App"
         optimize "On"
 
     filter {}
+
+-- The console projects build the game and the AI from the sources of the App
+-- but without the engine, so no window or OpenGL is needed
+
+function HeadlessProject(name)
+    project (name)
+        location (name)
+        kind "ConsoleApp"
+        language "C++"
+        cppdialect "C++20"
+        staticruntime "On"
+
+        targetdir ("%{wks.location}/Build/Target/" .. OUTPUT_DIR .. "/%{prj.name}")
+        objdir ("%{wks.location}/Build/Obj/" .. OUTPUT_DIR .. "/%{prj.name}")
+
+        files
+        {
+            "%{prj.name}/Include/*.hpp",
+            "%{prj.name}/Sources/*.cpp",
+            "App/Include/*.hpp",
+            "App/Sources/*.cpp"
+        }
+
+        removefiles
+        {
+            "App/Include/App.hpp",
+            "App/Sources/App.cpp",
+            "App/Sources/Main.cpp"
+        }
+
+        -- Including headers for libraries
+
+        includedirs
+        {
+            "%{prj.name}/Include",
+            "App/Include",
+            "Engine/Include"
+        }
+
+        -- Linking with libraries
+
+        filter "system:linux"
+            links { "pthread" }
+
+        -- Platform specific flags
+
+        filter "system:windows"
+            warnings "Extra"
+
+        filter {}
+
+        -- Build configurations
+
+        filter "configurations:Debug"
+            symbols "On"
+
+        filter "configurations:Release"
+            optimize "On"
+
+        filter {}
+end
+
+HeadlessProject "Simulator"
+HeadlessProject "Benchmark"
+HeadlessProject "Tests"